@@ -53,6 +53,10 @@ static char current_category[32];
 static char search_query[32];
 static int  search_query_len = 0;
 
+// Title prefix typed in the list view: SHIFT+letter or a digit jumps, a second one refines
+static char jump_prefix[3];
+static int  jump_len = 0;
+
 // Search category filter: 0=All, 1=Games, 2=Demos, 3=Music
 static int  search_category = 0;
 static const char *search_cat_names[] = {"All", "Games", "Demos", "Music"};
@@ -79,6 +83,11 @@ static bool adv_top200 = false;
 
 static const char *adv_type_names[] = {"Any", "prg", "d64", "crt", "sid"};
 
+// Match counts for the advanced search form (from FACETS), -1 = unknown
+static int  adv_type_counts[5];       // Per adv_type_names entry, index 0 unused
+static int  adv_top200_count = -1;
+static int  adv_match_count = -1;
+
 // Settings edit state
 static int  settings_cursor = 0;  // Which setting is selected
 static int  settings_edit_pos = 0;  // Cursor position in edit field
@@ -86,6 +95,7 @@ static bool settings_editing = false;  // Are we editing a field?
 
 // Line buffer for protocol
 static char line_buffer[128];
+static char command_buffer[128];
 
 // Info screen state
 static int info_return_page = PAGE_CATS;  // Page to return to after info
@@ -157,6 +167,18 @@ void print_status(const char *msg)
     print_at(0, 24, msg);
 }
 
+// Show "ready" after a command; stats builds (make STATS=1) also show the
+// UCI socket reads and empty polls the command's response took.
+void print_ready(void)
+{
+    print_status("ready");
+#ifdef UCI_STATS
+    char buf[16];
+    sprintf(buf, "r%d p%d", (int)uci_read_count, (int)uci_poll_count);
+    print_at(28, 24, buf);
+#endif
+}
+
 //-----------------------------------------------------------------------------
 // Settings
 //-----------------------------------------------------------------------------
@@ -220,6 +242,10 @@ void save_settings(void)
 // Network
 //-----------------------------------------------------------------------------
 
+// Protocol helpers, defined below
+void send_command(const char *cmd);
+int read_line(void);
+
 bool connect_to_server(void)
 {
     print_status("connecting...");
@@ -237,6 +263,14 @@ bool connect_to_server(void)
     // Read greeting line "OK c64uploader"
     uci_tcp_nextline(socket_id, line_buffer);
 
+#ifndef UCI_NO_FRAME
+    // Ask for responses in chunks of whole lines that fit one socket read.
+    // Servers without framing answer ERR, which is ignored.
+    sprintf(line_buffer, "FRAME %d", UCI_READ_WINDOW);
+    send_command(line_buffer);
+    read_line();
+#endif
+
     print_status("connected!");
     return true;
 }
@@ -259,8 +293,15 @@ void send_command(const char *cmd)
 {
     if (!connected)
         return;
-    uci_socket_write(socket_id, cmd);
-    uci_socket_write_char(socket_id, '\n');
+
+    // Append the newline so the command costs a single socket write.
+    strncpy(command_buffer, cmd, sizeof(command_buffer) - 2);
+    command_buffer[sizeof(command_buffer) - 2] = 0;
+    strcat(command_buffer, "\n");
+
+    uci_read_count = 0;
+    uci_poll_count = 0;
+    uci_socket_write(socket_id, command_buffer);
 }
 
 // Read a line from server, returns length
@@ -310,7 +351,7 @@ void load_categories(void)
     cursor = 0;
     offset = 0;
     current_page = 0;
-    print_status("ready");
+    print_ready();
 }
 
 // Load entries for a category
@@ -375,7 +416,27 @@ void load_entries(const char *category, int start)
 
     cursor = 0;
     current_page = 1;
-    print_status("ready");
+    print_ready();
+}
+
+// Jump the list to the first title starting with prefix (one JUMP round trip)
+bool jump_to(const char *category, const char *prefix)
+{
+    print_status("jumping...");
+
+    char cmd[64];
+    sprintf(cmd, "JUMP %s %s", category, prefix);
+    send_command(cmd);
+    read_line();  // "OK offset total" or "ERR ..."
+
+    if (line_buffer[0] == 'E')
+    {
+        print_status(line_buffer);
+        return false;
+    }
+
+    load_entries(category, atoi(line_buffer + 3));
+    return true;
 }
 
 // Run selected entry
@@ -451,18 +512,12 @@ void do_search(const char *query, int start)
 
     cursor = 0;
     current_page = 2;
-    print_status("ready");
+    print_ready();
 }
 
-// Execute advanced search
-void do_adv_search(int start)
+// Append the advanced search form filters as " key=value" pairs
+void append_adv_filters(char *cmd)
 {
-    print_status("searching...");
-
-    // Build command: "ADVSEARCH offset count [key=value ...]"
-    char cmd[96];
-    sprintf(cmd, "ADVSEARCH %d 20", start);
-
     // Add category filter
     if (adv_category > 0)
     {
@@ -496,6 +551,79 @@ void do_adv_search(int start)
     {
         strcat(cmd, " top200=1");
     }
+}
+
+// Fetch match counts per type and top200 for the advanced search form
+void fetch_adv_facets(void)
+{
+    print_status("counting...");
+
+    char cmd[96];
+    strcpy(cmd, "FACETS");
+    append_adv_filters(cmd);
+    send_command(cmd);
+    read_line();  // "OK n total" or "ERR ..."
+
+    for (int i = 0; i < 5; i++)
+        adv_type_counts[i] = 0;
+    adv_top200_count = 0;
+    adv_match_count = -1;
+
+    if (line_buffer[0] != 'O')
+    {
+        // Server without FACETS support
+        adv_top200_count = -1;
+        for (int i = 0; i < 5; i++)
+            adv_type_counts[i] = -1;
+        print_ready();
+        return;
+    }
+
+    // Parse "OK n total"
+    char *p = strchr(line_buffer + 3, ' ');
+    if (p)
+        adv_match_count = atoi(p + 1);
+
+    // Read "field|value|count" lines until "."
+    while (1)
+    {
+        read_line();
+        if (line_buffer[0] == '.')
+            break;
+
+        char *value = strchr(line_buffer, '|');
+        if (!value)
+            continue;
+        *value++ = 0;
+        char *count = strchr(value, '|');
+        if (!count)
+            continue;
+        *count++ = 0;
+
+        if (strcmp(line_buffer, "type") == 0)
+        {
+            for (int i = 1; i < 5; i++)
+            {
+                if (strcmp(value, adv_type_names[i]) == 0)
+                    adv_type_counts[i] = atoi(count);
+            }
+        }
+        else if (strcmp(line_buffer, "top200") == 0)
+            adv_top200_count = atoi(count);
+    }
+
+    print_ready();
+}
+
+// Execute advanced search
+void do_adv_search(int start)
+{
+    print_status("searching...");
+
+    // Build command: "ADVSEARCH offset count [key=value ...]"
+    char cmd[96];
+    sprintf(cmd, "ADVSEARCH %d 20", start);
+    append_adv_filters(cmd);
 
     send_command(cmd);
     read_line();  // "OK n total"
@@ -541,7 +669,7 @@ void do_adv_search(int start)
         read_line();
 
     cursor = 0;
-    print_status("ready");
+    print_ready();
 }
 
 // Fetch info for an entry
@@ -590,7 +718,7 @@ bool fetch_info(int id)
     while (line_buffer[0] != '.')
         read_line();
 
-    print_status("ready");
+    print_ready();
     return info_line_count > 0;
 }
 
@@ -639,13 +767,23 @@ char get_key(void)
         // In list view
         else if (current_page == PAGE_LIST)
         {
-            if (k == KSCAN_W) return 'u';
+            // Unshifted letters only: SHIFT+letter is a jump
+            if (k == KSCAN_W && !shift) return 'u';
             if (k == KSCAN_CSR_DOWN && shift) return 'u';
-            if (k == KSCAN_S || k == KSCAN_CSR_DOWN) return 'd';
-            if (k == KSCAN_N) return 'n';
-            if (k == KSCAN_P) return 'p';
-            if (k == KSCAN_I) return 'i';  // Info
+            if ((k == KSCAN_S && !shift) || k == KSCAN_CSR_DOWN) return 'd';
+            if (k == KSCAN_N && !shift) return 'n';
+            if (k == KSCAN_P && !shift) return 'p';
+            if (k == KSCAN_I && !shift) return 'i';  // Info
             if (k == KSCAN_CSR_RIGHT && shift) return 8;  // Left = back
+
+            // SHIFT+letter or digit = jump to titles starting with it
+            if (k < 64)
+            {
+                byte c = (byte)keyb_codes[shift ? k + 64 : k];
+                if (shift && c >= 'A' && c <= 'Z') return c;
+                if (shift && c >= 'a' && c <= 'z') return c - 32;
+                if (!shift && c >= '0' && c <= '9') return c;
+            }
         }
         // In search mode
         else if (current_page == PAGE_SEARCH)
@@ -899,6 +1037,7 @@ void draw_adv_field(int field, bool selected)
 {
     byte y = 2 + field * 2;  // Fields at rows 2, 4, 6, 8, 10, 12
     byte color = selected ? 1 : 14;
+    char count_str[16];
 
     clear_line(y);
 
@@ -946,15 +1085,30 @@ void draw_adv_field(int field, bool selected)
         print_at_color(10, y, "[", color);
         print_at_color(11, y, adv_type_names[adv_type], 5);
         print_at_color(11 + strlen(adv_type_names[adv_type]), y, "]", color);
+        if (adv_type > 0 && adv_type_counts[adv_type] >= 0)
+        {
+            sprintf(count_str, "(%d)", adv_type_counts[adv_type]);
+            print_at_color(17, y, count_str, adv_type_counts[adv_type] ? 11 : 2);
+        }
         break;
 
     case ADV_FIELD_TOP200:
         print_at_color(2, y, "top200:", color);
         print_at_color(10, y, adv_top200 ? "[yes]" : "[no]", adv_top200 ? 5 : 11);
+        if (adv_top200_count >= 0)
+        {
+            sprintf(count_str, "(%d)", adv_top200_count);
+            print_at_color(17, y, count_str, adv_top200_count ? 11 : 2);
+        }
         break;
 
     case ADV_FIELD_SEARCH:
         print_at_color(2, y, "[search]", color);
+        if (adv_match_count >= 0)
+        {
+            sprintf(count_str, "%d matches", adv_match_count);
+            print_at_color(12, y, count_str, adv_match_count ? 11 : 2);
+        }
         break;
     }
 }
@@ -1172,6 +1326,11 @@ int main(void)
 
         if (key != 0)
         {
+            // Any key but another jump character starts a new jump prefix
+            bool jump_key = (key >= 'A' && key <= 'Z') || (key >= '0' && key <= '9');
+            if (current_page != PAGE_LIST || !jump_key)
+                jump_len = 0;
+
             // Get current title
             const char *title = "assembly64 - categories";
             if (current_page == PAGE_LIST)
@@ -1209,6 +1368,7 @@ int main(void)
                     adv_group[0] = 0;
                     adv_type = 0;
                     adv_top200 = false;
+                    fetch_adv_facets();
                     item_count = 0;
                     total_count = 0;
                     cursor = 0;
@@ -1324,16 +1484,19 @@ int main(void)
                     if (adv_cursor == ADV_FIELD_CAT)
                     {
                         adv_category = (adv_category + 1) % 4;
+                        fetch_adv_facets();
                         draw_adv_search();
                     }
                     else if (adv_cursor == ADV_FIELD_TYPE)
                     {
                         adv_type = (adv_type + 1) % 5;
+                        fetch_adv_facets();
                         draw_adv_search();
                     }
                     else if (adv_cursor == ADV_FIELD_TOP200)
                     {
                         adv_top200 = !adv_top200;
+                        fetch_adv_facets();
                         draw_adv_search();
                     }
                 }
@@ -1381,8 +1544,9 @@ int main(void)
                 {
                     if (adv_editing)
                     {
-                        // Exit edit mode
+                        // Exit edit mode and recount with the new text
                         adv_editing = false;
+                        fetch_adv_facets();
                         draw_adv_search();
                     }
                     else if (adv_cursor == ADV_FIELD_TITLE)
@@ -1562,9 +1726,20 @@ int main(void)
                 break;
 
             default:
-                // Typed character in search mode
-                if (current_page == PAGE_SEARCH &&
+                // Jump character in list view
+                if (current_page == PAGE_LIST &&
                     ((key >= 'A' && key <= 'Z') || (key >= '0' && key <= '9')))
+                {
+                    if (jump_len >= 2)
+                        jump_len = 0;
+                    jump_prefix[jump_len++] = key;
+                    jump_prefix[jump_len] = 0;
+                    if (jump_to(current_category, jump_prefix))
+                        draw_list(title);
+                }
+                // Typed character in search mode
+                else if (current_page == PAGE_SEARCH &&
+                         ((key >= 'A' && key <= 'Z') || (key >= '0' && key <= '9')))
                 {
                     if (search_query_len < 30)
                     {
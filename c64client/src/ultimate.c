@@ -12,6 +12,8 @@
 // Global buffers
 char uci_status[UCI_STATUS_QUEUE_SZ];
 char uci_data[UCI_DATA_QUEUE_SZ * 2];
+uint16_t uci_read_count = 0;
+uint16_t uci_poll_count = 0;
 
 // Internal state
 static uint8_t uci_target = UCI_TARGET_DOS1;
@@ -627,10 +629,13 @@ char uci_tcp_nextchar(uint8_t socketid)
     {
         do
         {
-            uci_data_len = uci_socket_read(socketid, UCI_DATA_QUEUE_SZ - 4);
+            uci_data_len = uci_socket_read(socketid, UCI_READ_WINDOW);
             if (uci_data_len == 0)
                 return 0; // EOF
+            if (uci_data_len == -1)
+                uci_poll_count++;
         } while (uci_data_len == -1);
+        uci_read_count++;
 
         result = uci_data[2];
         uci_data_index = 1;
@@ -41,6 +41,9 @@
 #define UCI_DATA_QUEUE_SZ   896
 #define UCI_STATUS_QUEUE_SZ 256
 
+// Most bytes uci_tcp_nextchar requests per socket read
+#define UCI_READ_WINDOW     (UCI_DATA_QUEUE_SZ - 4)
+
 // Target IDs
 #define UCI_TARGET_DOS1     0x01
 #define UCI_TARGET_DOS2     0x02
@@ -107,6 +110,10 @@
 extern char uci_status[UCI_STATUS_QUEUE_SZ];
 extern char uci_data[UCI_DATA_QUEUE_SZ * 2];
 
+// Socket reads issued by uci_tcp_nextchar, for measuring UCI transactions
+extern uint16_t uci_read_count;  // Reads that returned data
+extern uint16_t uci_poll_count;  // Reads that found no data yet
+
 // Check if last command succeeded (status starts with "00")
 // Note: inline function instead of macro due to oscar64 preprocessor quirk
 inline bool uci_success(void)
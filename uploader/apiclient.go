@@ -3,6 +3,7 @@ package main
 
 import (
 	"bytes"
+	"context"
 	"encoding/json"
 	"fmt"
 	"io"
@@ -11,6 +12,7 @@ import (
 	"net/url"
 	"path/filepath"
 	"strings"
+	"sync"
 	"time"
 
 	"github.com/jlaffaye/ftp"
@@ -20,6 +22,9 @@ import (
 type APIClient struct {
 	Host       string
 	HTTPClient *http.Client
+
+	deviceMu sync.Mutex   // Held by the launch using the device, see lockDevice.
+	uploaded uploadedDisk // Disk image currently in /Temp, see launchDiskImage.
 }
 
 // APIResponse represents the standard JSON response from C64 Ultimate API.
@@ -39,11 +44,20 @@ func NewAPIClient(host string) *APIClient {
 
 // doRequest performs HTTP request and checks for errors in response.
 func (c *APIClient) doRequest(method, path string, body io.Reader) error {
+	return c.doRequestContext(context.Background(), method, path, body)
+}
+
+// doRequestContext performs an HTTP request that is aborted when ctx is cancelled.
+func (c *APIClient) doRequestContext(ctx context.Context, method, path string, body io.Reader) error {
 	url := fmt.Sprintf("http://%s%s", c.Host, path)
-	req, err := http.NewRequest(method, url, body)
+	req, err := http.NewRequestWithContext(ctx, method, url, body)
 	if err != nil {
 		return fmt.Errorf("creating request: %w", err)
 	}
+	// Send a Content-Length for progress readers too; the runners do not accept chunked bodies.
+	if pr, ok := body.(*progressReader); ok {
+		req.ContentLength = pr.total
+	}
 
 	resp, err := c.HTTPClient.Do(req)
 	if err != nil {
@@ -106,21 +120,21 @@ func (c *APIClient) runSID(fileData []byte) error {
 }
 
 // mountDisk mounts a disk image from the filesystem.
-func (c *APIClient) mountDisk(imagePath, imageType string) error {
+func (c *APIClient) mountDisk(ctx context.Context, imagePath, imageType string) error {
 	path := fmt.Sprintf("/v1/drives/a:mount?image=%s&type=%s&mode=readonly", url.QueryEscape(imagePath), imageType)
 	slog.Info("Mounting disk image from filesystem", "path", imagePath, "type", imageType)
-	return c.doRequest("PUT", path, nil)
+	return c.doRequestContext(ctx, "PUT", path, nil)
 }
 
 // removeDisk removes the mounted disk from drive A.
-func (c *APIClient) removeDisk() error {
+func (c *APIClient) removeDisk(ctx context.Context) error {
 	slog.Info("Removing previously mounted disk")
-	return c.doRequest("PUT", "/v1/drives/a:remove", nil)
+	return c.doRequestContext(ctx, "PUT", "/v1/drives/a:remove", nil)
 }
 
 // ftpConnect establishes a connection to the FTP server and logs in.
-func (c *APIClient) ftpConnect(ftpAddr string) (*ftp.ServerConn, error) {
-	conn, err := ftp.Dial(ftpAddr, ftp.DialWithTimeout(30*time.Second))
+func (c *APIClient) ftpConnect(ctx context.Context, ftpAddr string) (*ftp.ServerConn, error) {
+	conn, err := ftp.Dial(ftpAddr, ftp.DialWithTimeout(30*time.Second), ftp.DialWithContext(ctx))
 	if err != nil {
 		return nil, fmt.Errorf("connecting to FTP server: %w", err)
 	}
@@ -135,11 +149,12 @@ func (c *APIClient) ftpConnect(ftpAddr string) (*ftp.ServerConn, error) {
 }
 
 // ftpUpload uploads file data to the specified destination path via FTP.
-func (c *APIClient) ftpUpload(conn *ftp.ServerConn, fileData []byte, destination string) error {
+// The upload reports progress to tracker and stops when ctx is cancelled.
+func (c *APIClient) ftpUpload(ctx context.Context, conn *ftp.ServerConn, fileData []byte, destination string, tracker *launchTracker) error {
 	slog.Info("Uploading file via FTP", "path", destination, "size", len(fileData))
 
 	// Upload file.
-	if err := conn.Stor(destination, bytes.NewReader(fileData)); err != nil {
+	if err := conn.Stor(destination, newProgressReader(ctx, fileData, tracker)); err != nil {
 		return fmt.Errorf("FTP upload failed: %w", err)
 	}
 
@@ -147,11 +162,11 @@ func (c *APIClient) ftpUpload(conn *ftp.ServerConn, fileData []byte, destination
 	return nil
 }
 
-// uploadDiskViaFTP uploads a disk image to /Temp directory via FTP.
-func (c *APIClient) uploadDiskViaFTP(fileData []byte, filename string) (string, error) {
+// uploadDiskViaFTP uploads a disk image to /Temp directory via FTP, reporting progress to tracker.
+func (c *APIClient) uploadDiskViaFTP(ctx context.Context, fileData []byte, filename string, tracker *launchTracker) (string, error) {
 	// Connect to FTP server.
 	ftpAddr := fmt.Sprintf("%s:21", c.Host)
-	conn, err := c.ftpConnect(ftpAddr)
+	conn, err := c.ftpConnect(ctx, ftpAddr)
 	if err != nil {
 		return "", err
 	}
@@ -161,13 +176,28 @@ func (c *APIClient) uploadDiskViaFTP(fileData []byte, filename string) (string,
 	targetPath := filepath.Join("/Temp", filename)
 
 	// Upload file.
-	if err := c.ftpUpload(conn, fileData, targetPath); err != nil {
+	if err := c.ftpUpload(ctx, conn, fileData, targetPath, tracker); err != nil {
 		return "", err
 	}
 
 	return targetPath, nil
 }
 
+// remoteFileSize returns the size of a file on the device via FTP.
+func (c *APIClient) remoteFileSize(ctx context.Context, path string) (int64, error) {
+	conn, err := c.ftpConnect(ctx, fmt.Sprintf("%s:21", c.Host))
+	if err != nil {
+		return 0, err
+	}
+	defer conn.Quit()
+
+	size, err := conn.FileSize(path)
+	if err != nil {
+		return 0, fmt.Errorf("FTP size query failed: %w", err)
+	}
+	return size, nil
+}
+
 // injectKeyboardCommand injects a BASIC command into the C64 keyboard buffer.
 func (c *APIClient) injectKeyboardCommand(command string) error {
 	// C64 keyboard buffer is at $0277-$02A6 (631-678 decimal).
@@ -192,34 +222,10 @@ func (c *APIClient) injectKeyboardCommand(command string) error {
 
 // runDiskImage mounts a disk image and runs the first extracted PRG via DMA.
 func (c *APIClient) runDiskImage(fileData []byte, imageType, filename string) error {
-	// Extract first PRG file from disk image.
-	prgData, prgFilename, err := extractFirstPRG(fileData)
-	if err != nil {
-		return fmt.Errorf("extracting PRG from disk image: %w", err)
-	}
-
-	slog.Info("Extracted PRG from disk", "filename", prgFilename, "size", len(prgData), "imageType", imageType)
-
-	// Remove previously mounted disk to free up space.
-	if err := c.removeDisk(); err != nil {
-		// Log but don't fail - disk might not be mounted.
-		slog.Debug("Failed to remove previous disk (may not be mounted)", "error", err)
-	}
-
-	// Upload disk image to /Temp via FTP using hardcoded filename to avoid filling /Temp.
-	hardcodedFilename := "uploaded_disk." + imageType
-	remotePath, err := c.uploadDiskViaFTP(fileData, hardcodedFilename)
-	if err != nil {
-		return fmt.Errorf("uploading disk via FTP: %w", err)
-	}
-
-	// Mount the disk image from filesystem for multi-file support.
-	if err := c.mountDisk(remotePath, imageType); err != nil {
-		return fmt.Errorf("mounting disk image: %w", err)
-	}
-
-	slog.Info("Disk image mounted to drive A")
+	return c.runDiskFile(fileData, imageType, filename, prgLocation{file: firstPRGFile})
+}
 
-	// Run the extracted PRG via DMA for fastest startup.
-	return c.runPRG(prgData)
+// runDiskFile mounts a disk image and runs the PRG at loc via DMA.
+func (c *APIClient) runDiskFile(fileData []byte, imageType, filename string, loc prgLocation) error {
+	return c.launchDiskImage(context.Background(), fileData, imageType, filename, loc, nil)
 }
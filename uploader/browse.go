@@ -0,0 +1,130 @@
+// Group and composer browsing.
+// Entries are grouped by release group and by composer into adjacency lists built once
+// per index: each distinct name is interned and keeps its entries oldest first, so
+// GROUPS, BYGROUP and BYAUTHOR pages are slices of precomputed lists.
+package main
+
+import (
+	"sort"
+	"strings"
+)
+
+// browseList is an adjacency list from interned names to entries.
+type browseList struct {
+	names      []string                 // Display names (first spelling seen), ordered case-insensitively.
+	ids        map[string]int           // Lowercased name -> position in names.
+	entries    [][]int                  // Entries per name, by year, then title; unknown years last.
+	byCategory map[string][]browseCount // Category -> names with entries in it, in name order.
+}
+
+// browseCount is a name of a browseList and its number of entries in one category.
+type browseCount struct {
+	name  int32
+	count int32
+}
+
+// browseIndex holds the group and composer adjacency lists of an index.
+type browseIndex struct {
+	groups  browseList
+	authors browseList
+}
+
+// browseKey normalizes a group or composer name for lookups.
+func browseKey(name string) string {
+	return strings.ToLower(strings.TrimSpace(name))
+}
+
+// lookup returns the entries of a name (case-insensitive), oldest first.
+// The result must not be modified.
+func (l *browseList) lookup(name string) []int {
+	if id, ok := l.ids[browseKey(name)]; ok {
+		return l.entries[id]
+	}
+	return nil
+}
+
+// browse returns the group and composer lists, building them on first use.
+func (index *SearchIndex) browse() *browseIndex {
+	index.browseOnce.Do(func() {
+		index.browseIdx = buildBrowseIndex(index)
+	})
+	return index.browseIdx
+}
+
+// buildBrowseIndex builds the adjacency lists in one pass over the year order, so every
+// list comes out sorted by year without sorting it.
+func buildBrowseIndex(index *SearchIndex) *browseIndex {
+	groups := newBrowseBuilder()
+	authors := newBrowseBuilder()
+	for _, i := range index.sortPermutation(sortYear) {
+		entry := &index.Entries[i]
+		groups.add(entry.Group, i)
+		authors.add(entry.Author, i)
+		if sid := entry.SID; sid != nil && !strings.EqualFold(sid.Author, entry.Author) {
+			authors.add(sid.Author, i)
+		}
+	}
+	return &browseIndex{
+		groups:  groups.build(index.Entries),
+		authors: authors.build(index.Entries),
+	}
+}
+
+// browseBuilder interns names while the adjacency lists are filled.
+type browseBuilder struct {
+	list browseList
+	keys []string // Lowercased name per id.
+}
+
+func newBrowseBuilder() *browseBuilder {
+	return &browseBuilder{list: browseList{ids: make(map[string]int)}}
+}
+
+// add appends entry i to the list of name; empty names are skipped.
+func (b *browseBuilder) add(name string, i int) {
+	key := browseKey(name)
+	if key == "" {
+		return
+	}
+	id, ok := b.list.ids[key]
+	if !ok {
+		id = len(b.list.names)
+		b.list.ids[key] = id
+		b.list.names = append(b.list.names, strings.TrimSpace(name))
+		b.list.entries = append(b.list.entries, nil)
+		b.keys = append(b.keys, key)
+	}
+	b.list.entries[id] = append(b.list.entries[id], i)
+}
+
+// build orders the names and counts their entries per category.
+func (b *browseBuilder) build(entries []ReleaseEntry) browseList {
+	order := make([]int, len(b.list.names))
+	for i := range order {
+		order[i] = i
+	}
+	sort.Slice(order, func(x, y int) bool { return b.keys[order[x]] < b.keys[order[y]] })
+
+	l := browseList{
+		names:      make([]string, len(order)),
+		ids:        b.list.ids,
+		entries:    make([][]int, len(order)),
+		byCategory: make(map[string][]browseCount),
+	}
+	counts := make(map[string]int32)
+	for pos, id := range order {
+		l.names[pos] = b.list.names[id]
+		l.entries[pos] = b.list.entries[id]
+		l.ids[b.keys[id]] = pos
+
+		clear(counts)
+		for _, i := range l.entries[pos] {
+			counts[entries[i].CategoryName]++
+		}
+		for cat, n := range counts {
+			l.byCategory[cat] = append(l.byCategory[cat], browseCount{name: int32(pos), count: n})
+		}
+		l.byCategory["All"] = append(l.byCategory["All"], browseCount{name: int32(pos), count: int32(len(l.entries[pos]))})
+	}
+	return l
+}
@@ -1,22 +1,20 @@
-// D64 disk image parsing and extraction functionality.
-// It supports reading directory entries and extracting PRG files from D64 disk images.
+// CBM disk image parsing and extraction functionality.
+// It supports D64 (35 and 40 tracks), D71 and D81 images, and GCR-encoded G64/G71 images
+// after decoding them in g64.go, with directory, header and BAM parsing on top.
 package main
 
 import (
 	"fmt"
 	"log/slog"
+	"strings"
 )
 
-// D64 disk image constants.
+// Disk image constants.
 const (
 	// Standard D64 has 35 tracks.
 	d64Tracks35 = 35
 	d64Tracks40 = 40
 
-	// Directory is always on track 18.
-	directoryTrack  = 18
-	directorySector = 1
-
 	// Bytes per sector.
 	bytesPerSector = 256
 
@@ -28,199 +26,439 @@ const (
 	fileTypeREL = 4
 )
 
-// Sector offsets for different track zones.
-var sectorsPerTrack = []int{
-	21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, // Tracks 1-17
-	19, 19, 19, 19, 19, 19, 19, // Tracks 18-24
-	18, 18, 18, 18, 18, 18, // Tracks 25-30
-	17, 17, 17, 17, 17, // Tracks 31-35
+// fileTypeNames are the directory listing names of the file types.
+var fileTypeNames = [...]string{"DEL", "SEQ", "PRG", "USR", "REL"}
+
+// diskFormat describes the geometry and filesystem layout of one disk image format.
+type diskFormat struct {
+	name         string
+	sectors      []int // Sectors per track, indexed by track-1.
+	trackOffsets []int // Byte offset of each track, indexed by track-1.
+	size         int   // Image size in bytes, without error info.
+
+	headerTrack, headerSector int // Sector holding the disk name and ID.
+	nameOffset, idOffset      int
+	dirTrack, dirSector       int // First directory sector.
+}
+
+// newDiskFormat creates a format and precomputes its track offset table,
+// so that sector offsets are found in constant time.
+func newDiskFormat(name string, sectors []int, header, dir [2]int, nameOffset, idOffset int) *diskFormat {
+	f := &diskFormat{
+		name:         name,
+		sectors:      sectors,
+		trackOffsets: make([]int, len(sectors)),
+		headerTrack:  header[0],
+		headerSector: header[1],
+		nameOffset:   nameOffset,
+		idOffset:     idOffset,
+		dirTrack:     dir[0],
+		dirSector:    dir[1],
+	}
+	offset := 0
+	for i, n := range sectors {
+		f.trackOffsets[i] = offset
+		offset += n * bytesPerSector
+	}
+	f.size = offset
+	return f
+}
+
+// sectorCount returns the total number of sectors of the format.
+func (f *diskFormat) sectorCount() int {
+	return f.size / bytesPerSector
 }
 
-// getSectorOffset calculates the byte offset for a given track and sector.
-func getSectorOffset(track, sector int) int {
-	if track < 1 || track > len(sectorsPerTrack) {
+// errorInfoSize returns the image size of the format with one error byte per sector appended.
+func (f *diskFormat) errorInfoSize() int {
+	return f.size + f.sectorCount()
+}
+
+// sectorOffset returns the byte offset of a track and sector, or -1 if it is out of range.
+func (f *diskFormat) sectorOffset(track, sector int) int {
+	if track < 1 || track > len(f.sectors) || sector < 0 || sector >= f.sectors[track-1] {
 		return -1
 	}
+	return f.trackOffsets[track-1] + sector*bytesPerSector
+}
 
-	offset := 0
-	// Sum sectors from all previous tracks.
-	for t := 1; t < track; t++ {
-		offset += sectorsPerTrack[t-1] * bytesPerSector
+// d64Zones returns the sectors per track of a 1541 disk with the given number of tracks.
+func d64Zones(tracks int) []int {
+	sectors := make([]int, tracks)
+	for t := 1; t <= tracks; t++ {
+		switch {
+		case t <= 17:
+			sectors[t-1] = 21
+		case t <= 24:
+			sectors[t-1] = 19
+		case t <= 30:
+			sectors[t-1] = 18
+		default:
+			sectors[t-1] = 17
+		}
 	}
+	return sectors
+}
+
+// Supported disk image formats.
+var (
+	formatD64 = newDiskFormat("d64", d64Zones(d64Tracks35), [2]int{18, 0}, [2]int{18, 1}, 0x90, 0xA2)
+
+	formatD64Tracks40 = newDiskFormat("d64", d64Zones(d64Tracks40), [2]int{18, 0}, [2]int{18, 1}, 0x90, 0xA2)
 
-	// Add sectors within the current track.
-	offset += sector * bytesPerSector
+	// The second side of a 1571 disk repeats the zones of the first.
+	formatD71 = newDiskFormat("d71", append(d64Zones(d64Tracks35), d64Zones(d64Tracks35)...), [2]int{18, 0}, [2]int{18, 1}, 0x90, 0xA2)
 
-	return offset
+	formatD81 = newDiskFormat("d81", repeatSectors(80, 40), [2]int{40, 0}, [2]int{40, 3}, 0x04, 0x16)
+)
+
+// repeatSectors returns a sector table of tracks tracks with n sectors each.
+func repeatSectors(tracks, n int) []int {
+	sectors := make([]int, tracks)
+	for i := range sectors {
+		sectors[i] = n
+	}
+	return sectors
 }
 
-// directoryEntry represents a file entry in the D64 directory.
-type directoryEntry struct {
-	fileType byte
-	track    byte
-	sector   byte
-	filename string
+// diskFormatsByType lists the formats a file type may hold, by image type.
+var diskFormatsByType = map[string][]*diskFormat{
+	"d64": {formatD64, formatD64Tracks40},
+	"d71": {formatD71},
+	"d81": {formatD81},
 }
 
-// parseDirectoryEntry parses a 32-byte directory entry.
-func parseDirectoryEntry(data []byte) *directoryEntry {
-	if len(data) < 32 {
-		return nil
+// diskImage is a parsed disk image. Sectors are slices of the image data.
+type diskImage struct {
+	format *diskFormat
+	data   []byte
+}
+
+// openDiskImage identifies the format of a disk image of the given type
+// (d64, d71, d81, g64, g71) by its size. GCR images are decoded first.
+func openDiskImage(data []byte, imageType string) (*diskImage, error) {
+	imageType = strings.ToLower(imageType)
+	switch imageType {
+	case "g64", "g71":
+		return decodeGCRImage(data)
+	}
+
+	formats, ok := diskFormatsByType[imageType]
+	if !ok {
+		return nil, fmt.Errorf("unsupported disk image type: %s", imageType)
+	}
+	for _, f := range formats {
+		if len(data) == f.size || len(data) == f.errorInfoSize() {
+			return &diskImage{format: f, data: data[:f.size]}, nil
+		}
 	}
 
-	// Byte 0x00: File type (bits 0-3 = type, bit 7 = closed flag).
-	fileType := data[0x00] & 0x0F
+	var sizes []string
+	for _, f := range formats {
+		sizes = append(sizes, fmt.Sprintf("%d", f.size), fmt.Sprintf("%d", f.errorInfoSize()))
+	}
+	return nil, fmt.Errorf("invalid %s size: %d bytes (expected one of %s)", strings.ToUpper(imageType), len(data), strings.Join(sizes, ", "))
+}
+
+// sector returns the data of a track and sector without copying.
+func (img *diskImage) sector(track, sector int) ([]byte, error) {
+	offset := img.format.sectorOffset(track, sector)
+	if offset < 0 {
+		return nil, fmt.Errorf("invalid sector: track %d, sector %d", track, sector)
+	}
+	return img.data[offset : offset+bytesPerSector], nil
+}
+
+// header returns the disk name and ID.
+func (img *diskImage) header() (name, id string) {
+	data, err := img.sector(img.format.headerTrack, img.format.headerSector)
+	if err != nil {
+		return "", ""
+	}
+	return petsciiString(data[img.format.nameOffset : img.format.nameOffset+16]),
+		petsciiString(data[img.format.idOffset : img.format.idOffset+2])
+}
 
-	// Bytes 0x01-0x02: Track/sector of first file block.
-	track := data[0x01]
-	sector := data[0x02]
+// blocksFree returns the number of free blocks according to the BAM,
+// not counting the directory track.
+func (img *diskImage) blocksFree() int {
+	free := 0
+	switch img.format {
+	case formatD64, formatD64Tracks40, formatD71:
+		// Tracks 36-40 of 40-track images use DOS-specific BAM extensions and are not counted.
+		bam, _ := img.sector(18, 0)
+		for t := 1; t <= d64Tracks35; t++ {
+			if t != 18 {
+				free += int(bam[4+4*(t-1)])
+			}
+		}
+		if img.format == formatD71 {
+			// Free counts of the second side are in the first BAM sector too.
+			for t := 36; t <= 70; t++ {
+				if t != 53 {
+					free += int(bam[0xDD+t-36])
+				}
+			}
+		}
+	case formatD81:
+		for half, sector := range []int{1, 2} {
+			bam, _ := img.sector(40, sector)
+			for i := 0; i < 40; i++ {
+				if t := half*40 + i + 1; t != 40 {
+					free += int(bam[0x10+6*i])
+				}
+			}
+		}
+	}
+	return free
+}
 
-	// Bytes 0x03-0x12: Filename (16 bytes, PETSCII, padded with 0xA0).
-	filename := ""
-	for i := 0x03; i <= 0x12; i++ {
-		if data[i] == 0xA0 || data[i] == 0x00 {
+// petsciiString converts a PETSCII name padded with 0xA0 to ASCII.
+func petsciiString(data []byte) string {
+	var b strings.Builder
+	for _, ch := range data {
+		if ch == 0xA0 || ch == 0x00 {
 			break
 		}
 		// Convert PETSCII to ASCII (basic conversion).
-		ch := data[i]
 		if ch >= 0xC1 && ch <= 0xDA { // Shifted A-Z
 			ch = ch - 0x80 // Convert to normal ASCII
 		}
 		// A-Z remains unchanged.
-		filename += string(ch)
+		b.WriteByte(ch)
 	}
+	return b.String()
+}
 
-	return &directoryEntry{
-		fileType: fileType,
-		track:    track,
-		sector:   sector,
-		filename: filename,
+// directoryEntry represents a file entry in the disk directory.
+type directoryEntry struct {
+	fileType byte // Bits 0-3 of the type byte.
+	closed   bool // Bit 7 of the type byte; unclosed files are shown as *PRG.
+	locked   bool // Bit 6 of the type byte.
+	track    byte
+	sector   byte
+	filename string
+	blocks   int
+}
+
+// typeName returns the directory listing name of the file type.
+func (e *directoryEntry) typeName() string {
+	if int(e.fileType) < len(fileTypeNames) {
+		return fileTypeNames[e.fileType]
 	}
+	return "???"
 }
 
-// findFirstPRGInDirectory scans D64 directory sectors to find the first PRG file entry.
-func findFirstPRGInDirectory(d64Data []byte) (*directoryEntry, error) {
-	currentTrack := directoryTrack
-	currentSector := directorySector
+// parseDirectoryEntry parses a 32-byte directory entry.
+func parseDirectoryEntry(data []byte) *directoryEntry {
+	if len(data) < 32 {
+		return nil
+	}
+
+	return &directoryEntry{
+		// Byte 0x00: File type (bits 0-3 = type, bit 6 = locked, bit 7 = closed flag).
+		fileType: data[0x00] & 0x0F,
+		closed:   data[0x00]&0x80 != 0,
+		locked:   data[0x00]&0x40 != 0,
+		// Bytes 0x01-0x02: Track/sector of first file block.
+		track:  data[0x01],
+		sector: data[0x02],
+		// Bytes 0x03-0x12: Filename (16 bytes, PETSCII, padded with 0xA0).
+		filename: petsciiString(data[0x03:0x13]),
+		// Bytes 0x1E-0x1F: File size in blocks, little-endian.
+		blocks: int(data[0x1E]) | int(data[0x1F])<<8,
+	}
+}
 
-	for {
-		offset := getSectorOffset(currentTrack, currentSector)
-		if offset < 0 || offset+bytesPerSector > len(d64Data) {
+// directory returns all used entries of the disk directory in order.
+func (img *diskImage) directory() ([]directoryEntry, error) {
+	var entries []directoryEntry
+	track, sector := img.format.dirTrack, img.format.dirSector
+	visited := newSectorBitmap(img.format)
+
+	for n := 0; ; n++ {
+		offset := img.format.sectorOffset(track, sector)
+		if offset < 0 {
+			if n == 0 {
+				return nil, fmt.Errorf("reading directory: invalid sector: track %d, sector %d", track, sector)
+			}
 			break
 		}
-
-		sectorData := d64Data[offset : offset+bytesPerSector]
-		nextTrack := sectorData[0x00]
-		nextSector := sectorData[0x01]
+		// A directory that links back to itself ends at the loop.
+		if visited.visit(offset) {
+			slog.Debug("Directory chain loops", "track", track, "sector", sector)
+			break
+		}
+		sectorData := img.data[offset : offset+bytesPerSector]
 
 		// Check 8 directory entries in this sector.
-		if entry := scanDirectorySector(sectorData); entry != nil {
-			return entry, nil
+		for i := 0; i < 8; i++ {
+			entryOffset := 0x02 + (i * 32)
+			entry := parseDirectoryEntry(sectorData[entryOffset : entryOffset+32])
+			if entry.track != 0 && (entry.closed || entry.fileType != fileTypeDEL) {
+				slog.Debug("Found file in disk image", "filename", entry.filename, "type", entry.fileType, "track", entry.track, "sector", entry.sector)
+				entries = append(entries, *entry)
+			}
 		}
 
 		// Move to next directory sector.
-		if nextTrack == 0 {
+		if sectorData[0x00] == 0 {
 			break
 		}
-		currentTrack = int(nextTrack)
-		currentSector = int(nextSector)
+		track, sector = int(sectorData[0x00]), int(sectorData[0x01])
 	}
 
-	return nil, fmt.Errorf("no PRG files found in D64 image")
+	return entries, nil
 }
 
-// scanDirectorySector scans a single directory sector for PRG files.
-func scanDirectorySector(sectorData []byte) *directoryEntry {
-	for i := 0; i < 8; i++ {
-		entryOffset := 0x02 + (i * 32)
-		if entryOffset+32 > len(sectorData) {
-			break
-		}
-
-		entry := parseDirectoryEntry(sectorData[entryOffset : entryOffset+32])
-		if entry != nil && entry.track != 0 {
-			slog.Debug("Found file in D64", "filename", entry.filename, "type", entry.fileType, "track", entry.track, "sector", entry.sector)
-			if entry.fileType == fileTypePRG {
-				slog.Info("Found PRG file in D64", "filename", entry.filename, "track", entry.track, "sector", entry.sector)
-				return entry
-			}
+// findFirstPRG returns the first PRG file entry in the directory.
+func (img *diskImage) findFirstPRG() (*directoryEntry, error) {
+	entries, err := img.directory()
+	if err != nil {
+		return nil, err
+	}
+	for i := range entries {
+		if entries[i].fileType == fileTypePRG {
+			slog.Info("Found PRG file in disk image", "filename", entries[i].filename, "track", entries[i].track, "sector", entries[i].sector)
+			return &entries[i], nil
 		}
 	}
-	return nil
+	return nil, fmt.Errorf("no PRG files found in %s image", strings.ToUpper(img.format.name))
+}
+
+// sectorBitmap marks sectors of an image, indexed by their position in the image.
+type sectorBitmap []uint64
+
+// newSectorBitmap returns an empty bitmap for all sectors of the format.
+func newSectorBitmap(f *diskFormat) sectorBitmap {
+	return make(sectorBitmap, (f.sectorCount()+63)/64)
+}
+
+// visit marks the sector at byte offset and reports whether it was already marked.
+func (b sectorBitmap) visit(offset int) bool {
+	i := offset / bytesPerSector
+	seen := b[i/64]&(1<<(i%64)) != 0
+	b[i/64] |= 1 << (i % 64)
+	return seen
 }
 
-// extractFileData follows the sector chain to extract file data from D64.
-func extractFileData(d64Data []byte, startTrack, startSector int) ([]byte, error) {
-	var fileData []byte
-	currentTrack := startTrack
-	currentSector := startSector
+// fileChunk is the used part of one sector of a file.
+type fileChunk struct {
+	offset, length int
+}
+
+// fileChain walks a file's sector chain and returns the used data of each sector.
+// A chain that leaves the disk or revisits a sector is an error.
+func (img *diskImage) fileChain(startTrack, startSector int) ([]fileChunk, int, error) {
+	visited := newSectorBitmap(img.format)
+	var chunks []fileChunk
+	size := 0
+	track, sector := startTrack, startSector
 
 	for {
-		offset := getSectorOffset(currentTrack, currentSector)
-		if offset < 0 || offset+bytesPerSector > len(d64Data) {
-			return nil, fmt.Errorf("invalid sector chain at track %d, sector %d", currentTrack, currentSector)
+		offset := img.format.sectorOffset(track, sector)
+		if offset < 0 {
+			return nil, 0, fmt.Errorf("invalid sector chain at track %d, sector %d", track, sector)
+		}
+		if visited.visit(offset) {
+			return nil, 0, fmt.Errorf("sector chain loops at track %d, sector %d", track, sector)
 		}
 
-		sectorData := d64Data[offset : offset+bytesPerSector]
-		nextTrack := sectorData[0x00]
-		nextSector := sectorData[0x01]
-
-		// Determine how many bytes to read from this sector.
+		nextTrack, nextSector := img.data[offset], img.data[offset+1]
 		if nextTrack == 0 {
-			// Last sector: nextSector indicates number of bytes used (1-255).
-			bytesToRead := int(nextSector)
-			if bytesToRead == 0 || bytesToRead > 255 {
-				bytesToRead = 254 // Default to nearly full sector.
+			// Last sector: nextSector is the index of the last used byte (1-255).
+			length := int(nextSector) - 1
+			if length < 1 {
+				length = 254 // Default to a full sector.
 			}
-			fileData = append(fileData, sectorData[2:2+bytesToRead]...)
-			break
+			chunks = append(chunks, fileChunk{offset + 2, length})
+			return chunks, size + length, nil
 		}
 
-		// Not last sector: use all 254 bytes of data.
-		fileData = append(fileData, sectorData[2:256]...)
-
-		// Safety check to prevent infinite loops.
-		if len(fileData) > 1024*1024 {
-			return nil, fmt.Errorf("file too large (>1MB), possible corrupt sector chain")
-		}
+		// Not last sector: all 254 bytes are data.
+		chunks = append(chunks, fileChunk{offset + 2, bytesPerSector - 2})
+		size += bytesPerSector - 2
+		track, sector = int(nextTrack), int(nextSector)
+	}
+}
 
-		// Move to next sector.
-		currentTrack = int(nextTrack)
-		currentSector = int(nextSector)
+// readFile extracts file data in two passes: the sector chain is walked first to size
+// the result, then each sector is copied once into it.
+func (img *diskImage) readFile(startTrack, startSector int) ([]byte, error) {
+	chunks, size, err := img.fileChain(startTrack, startSector)
+	if err != nil {
+		return nil, err
 	}
 
+	fileData := make([]byte, size)
+	pos := 0
+	for _, c := range chunks {
+		pos += copy(fileData[pos:], img.data[c.offset:c.offset+c.length])
+	}
 	return fileData, nil
 }
 
-// validateD64Size validates that the D64 data has a correct size.
-func validateD64Size(d64Data []byte) error {
-	expectedSize35 := 174848 // 35 tracks
-	expectedSize40 := 196608 // 40 tracks
-	if len(d64Data) != expectedSize35 && len(d64Data) != expectedSize40 {
-		return fmt.Errorf("invalid D64 size: %d bytes (expected %d or %d)", len(d64Data), expectedSize35, expectedSize40)
-	}
-	return nil
+// firstPRGFile selects the first PRG of a disk directory in extractPRG.
+const firstPRGFile = -1
+
+// prgLocation selects the PRG file to extract from a disk image.
+type prgLocation struct {
+	file   int // Directory position (0-based, as listed by directory), or firstPRGFile.
+	track  int // First sector of the file when known from the database, 0 otherwise.
+	sector int
+	name   string
 }
 
-// extractFirstPRG extracts the first PRG file from a D64 disk image.
-func extractFirstPRG(d64Data []byte) ([]byte, string, error) {
-	// Validate D64 size.
-	if err := validateD64Size(d64Data); err != nil {
-		return nil, "", err
-	}
+// extractFirstPRG extracts the first PRG file from a disk image of the given type.
+func extractFirstPRG(imageData []byte, imageType string) ([]byte, string, error) {
+	return extractPRG(imageData, imageType, prgLocation{file: firstPRGFile})
+}
 
-	// Find first PRG in directory.
-	firstPRG, err := findFirstPRGInDirectory(d64Data)
+// extractPRG extracts a PRG file from a disk image. The directory is only read when the
+// first sector of the file is not known.
+func extractPRG(imageData []byte, imageType string, loc prgLocation) ([]byte, string, error) {
+	img, err := openDiskImage(imageData, imageType)
 	if err != nil {
 		return nil, "", err
 	}
 
+	if loc.track != 0 {
+		prgData, err := img.readFile(loc.track, loc.sector)
+		if err != nil {
+			return nil, "", err
+		}
+		slog.Info("Extracted indexed PRG from disk image", "format", img.format.name, "filename", loc.name, "size", len(prgData))
+		return prgData, loc.name, nil
+	}
+
+	var entry *directoryEntry
+	file := loc.file
+	if file == firstPRGFile {
+		// Find first PRG in directory.
+		entry, err = img.findFirstPRG()
+		if err != nil {
+			return nil, "", err
+		}
+	} else {
+		entries, err := img.directory()
+		if err != nil {
+			return nil, "", err
+		}
+		if file < 0 || file >= len(entries) {
+			return nil, "", fmt.Errorf("invalid file number: %d", file)
+		}
+		entry = &entries[file]
+		if entry.fileType != fileTypePRG {
+			return nil, "", fmt.Errorf("%s is not a PRG file", entry.filename)
+		}
+	}
+
 	// Extract file data by following sector chain.
-	prgData, err := extractFileData(d64Data, int(firstPRG.track), int(firstPRG.sector))
+	prgData, err := img.readFile(int(entry.track), int(entry.sector))
 	if err != nil {
 		return nil, "", err
 	}
 
-	slog.Info("Extracted PRG from D64", "filename", firstPRG.filename, "size", len(prgData))
-	return prgData, firstPRG.filename, nil
+	slog.Info("Extracted PRG from disk image", "format", img.format.name, "filename", entry.filename, "size", len(prgData))
+	return prgData, entry.filename, nil
 }
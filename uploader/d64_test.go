@@ -0,0 +1,293 @@
+package main
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"strings"
+	"testing"
+)
+
+// testFileBlocks is the length in sectors of the file on generated test images.
+const testFileBlocks = 40
+
+// testDisk is a generated disk image with one PRG file on it.
+type testDisk struct {
+	imageType string
+	data      []byte
+	track     int // First sector of the file.
+	sector    int
+	file      []byte // Contents of the file.
+}
+
+// newTestImage returns a blank image of a format with an empty directory.
+func newTestImage(f *diskFormat) *diskImage {
+	img := &diskImage{format: f, data: make([]byte, f.size)}
+	dir, _ := img.sector(f.dirTrack, f.dirSector)
+	dir[0x01] = 0xFF
+	return img
+}
+
+// writeChain writes data along a sector chain, linking each sector to the next.
+func writeChain(t testing.TB, img *diskImage, chain [][2]int, data []byte) {
+	t.Helper()
+	for i, ts := range chain {
+		sector, err := img.sector(ts[0], ts[1])
+		if err != nil {
+			t.Fatal(err)
+		}
+		n := copy(sector[2:], data)
+		data = data[n:]
+		if i+1 < len(chain) {
+			sector[0], sector[1] = byte(chain[i+1][0]), byte(chain[i+1][1])
+		} else {
+			sector[0], sector[1] = 0, byte(n+1)
+		}
+	}
+}
+
+// addDirectoryEntry adds a closed PRG to the first free slot of the first directory sector.
+func addDirectoryEntry(img *diskImage, name string, track, sector, blocks int) {
+	dir, _ := img.sector(img.format.dirTrack, img.format.dirSector)
+	for i := 0; i < 8; i++ {
+		e := dir[0x02+i*32 : 0x22+i*32]
+		if e[0x01] != 0 {
+			continue
+		}
+		e[0x00] = 0x80 | fileTypePRG
+		e[0x01], e[0x02] = byte(track), byte(sector)
+		copy(e[0x03:0x13], bytes.Repeat([]byte{0xA0}, 16))
+		copy(e[0x03:0x13], strings.ToUpper(name))
+		e[0x1E], e[0x1F] = byte(blocks), byte(blocks>>8)
+		return
+	}
+}
+
+// newTestDisk generates an image of a type holding a PRG of testFileBlocks sectors,
+// laid out from track 1 with the sectors of each track in order.
+func newTestDisk(t testing.TB, imageType string) *testDisk {
+	t.Helper()
+	f := map[string]*diskFormat{"d64": formatD64, "d71": formatD71, "d81": formatD81, "g64": formatD64}[imageType]
+	img := newTestImage(f)
+
+	var chain [][2]int
+	for track := 1; len(chain) < testFileBlocks; track++ {
+		for s := 0; s < f.sectors[track-1] && len(chain) < testFileBlocks; s++ {
+			chain = append(chain, [2]int{track, s})
+		}
+	}
+	file := make([]byte, (testFileBlocks-1)*(bytesPerSector-2)+100)
+	for i := range file {
+		file[i] = byte(i * 7)
+	}
+	writeChain(t, img, chain, file)
+	addDirectoryEntry(img, "test", 1, 0, testFileBlocks)
+
+	data := img.data
+	if imageType == "g64" {
+		data = encodeG64(img)
+	}
+	return &testDisk{imageType: imageType, data: data, track: 1, sector: 0, file: file}
+}
+
+// gcrWriter packs GCR codes into a bit stream.
+type gcrWriter struct {
+	out   []byte
+	acc   uint64
+	nbits int
+}
+
+func (w *gcrWriter) bits(v uint64, n int) {
+	w.acc = w.acc<<n | v
+	w.nbits += n
+	for w.nbits >= 8 {
+		w.nbits -= 8
+		w.out = append(w.out, byte(w.acc>>w.nbits))
+	}
+}
+
+func (w *gcrWriter) sync() {
+	w.bits(0xFFFFFFFFFF, 40)
+}
+
+func (w *gcrWriter) gap(n int) {
+	for i := 0; i < n; i++ {
+		w.bits(0x55, 8)
+	}
+}
+
+func (w *gcrWriter) encode(data []byte) {
+	var codes [16]uint64
+	for code, nybble := range gcrDecodeTable {
+		if nybble >= 0 {
+			codes[nybble] = uint64(code)
+		}
+	}
+	for _, b := range data {
+		w.bits(codes[b>>4]<<5|codes[b&0x0F], 10)
+	}
+}
+
+// encodeG64 encodes a 35-track D64 image as a G64 image, one header and data block
+// per sector.
+func encodeG64(img *diskImage) []byte {
+	const halfTracks = 84
+	var tracks [][]byte
+	for track := 1; track <= d64Tracks35; track++ {
+		w := &gcrWriter{}
+		for s := 0; s < img.format.sectors[track-1]; s++ {
+			data, _ := img.sector(track, s)
+			hdr := []byte{gcrHeaderBlockID, 0, byte(s), byte(track), 'B', 'A', 0x0F, 0x0F}
+			hdr[1] = xorChecksum(hdr[2:6])
+			w.sync()
+			w.encode(hdr)
+			w.gap(9)
+
+			block := append([]byte{gcrDataBlockID}, data...)
+			block = append(block, xorChecksum(data), 0, 0)
+			w.sync()
+			w.encode(block)
+			w.gap(8)
+		}
+		tracks = append(tracks, w.out)
+	}
+
+	out := make([]byte, g64HeaderSize+halfTracks*8)
+	copy(out, "GCR-1541")
+	out[9] = halfTracks
+	binary.LittleEndian.PutUint16(out[10:], 7928)
+	for i, raw := range tracks {
+		binary.LittleEndian.PutUint32(out[g64HeaderSize+2*i*4:], uint32(len(out)))
+		out = binary.LittleEndian.AppendUint16(out, uint16(len(raw)))
+		out = append(out, raw...)
+	}
+	return out
+}
+
+var testImageTypes = []string{"d64", "d71", "d81", "g64"}
+
+func TestReadFile(t *testing.T) {
+	for _, imageType := range testImageTypes {
+		t.Run(imageType, func(t *testing.T) {
+			d := newTestDisk(t, imageType)
+			img, err := openDiskImage(d.data, imageType)
+			if err != nil {
+				t.Fatal(err)
+			}
+			got, err := img.readFile(d.track, d.sector)
+			if err != nil {
+				t.Fatal(err)
+			}
+			if !bytes.Equal(got, d.file) {
+				t.Errorf("readFile returned %d bytes, want the %d bytes written", len(got), len(d.file))
+			}
+
+			entries, err := img.directory()
+			if err != nil {
+				t.Fatal(err)
+			}
+			if len(entries) != 1 || entries[0].filename != "TEST" || entries[0].blocks != testFileBlocks {
+				t.Errorf("directory() = %+v, want one TEST entry of %d blocks", entries, testFileBlocks)
+			}
+		})
+	}
+}
+
+func TestReadFileLoop(t *testing.T) {
+	img := newTestImage(formatD64)
+	writeChain(t, img, [][2]int{{1, 0}, {1, 1}, {1, 2}}, make([]byte, 3*254))
+	last, _ := img.sector(1, 2)
+	last[0], last[1] = 1, 1 // Link back to the second sector.
+
+	_, err := img.readFile(1, 0)
+	if err == nil || !strings.Contains(err.Error(), "loops at track 1, sector 1") {
+		t.Errorf("readFile of a looping chain: err = %v, want a loop at track 1, sector 1", err)
+	}
+}
+
+func TestReadFileOutOfRange(t *testing.T) {
+	for _, link := range [][2]int{{36, 0}, {17, 21}, {0xFF, 0}} {
+		t.Run(fmt.Sprintf("%d/%d", link[0], link[1]), func(t *testing.T) {
+			img := newTestImage(formatD64)
+			writeChain(t, img, [][2]int{{1, 0}, {1, 1}}, make([]byte, 300))
+			last, _ := img.sector(1, 1)
+			last[0], last[1] = byte(link[0]), byte(link[1])
+
+			_, err := img.readFile(1, 0)
+			want := fmt.Sprintf("invalid sector chain at track %d, sector %d", link[0], link[1])
+			if err == nil || err.Error() != want {
+				t.Errorf("readFile: err = %v, want %q", err, want)
+			}
+		})
+	}
+
+	img := newTestImage(formatD64)
+	if _, err := img.readFile(0, 0); err == nil {
+		t.Error("readFile(0, 0) succeeded, want an invalid sector error")
+	}
+}
+
+func TestReadFileLastSectorLength(t *testing.T) {
+	tests := []struct {
+		lastByte byte
+		want     int
+	}{
+		// Counts below 2 leave no data byte and are read as a full sector.
+		{0, 254},
+		{1, 254},
+		{2, 1},
+		{101, 100},
+		{255, 254},
+	}
+	for _, tt := range tests {
+		img := newTestImage(formatD64)
+		writeChain(t, img, [][2]int{{1, 0}, {1, 1}}, make([]byte, 2*254))
+		last, _ := img.sector(1, 1)
+		last[1] = tt.lastByte
+
+		data, err := img.readFile(1, 0)
+		if err != nil {
+			t.Fatalf("last byte %d: %v", tt.lastByte, err)
+		}
+		if len(data) != 254+tt.want {
+			t.Errorf("last byte %d: readFile returned %d bytes, want %d", tt.lastByte, len(data), 254+tt.want)
+		}
+	}
+}
+
+func BenchmarkReadFile(b *testing.B) {
+	for _, imageType := range testImageTypes {
+		d := newTestDisk(b, imageType)
+		b.Run(imageType, func(b *testing.B) {
+			b.SetBytes(int64(len(d.file)))
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				img, err := openDiskImage(d.data, d.imageType)
+				if err != nil {
+					b.Fatal(err)
+				}
+				if _, err := img.readFile(d.track, d.sector); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
+
+func BenchmarkDirectory(b *testing.B) {
+	for _, imageType := range testImageTypes {
+		d := newTestDisk(b, imageType)
+		b.Run(imageType, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				img, err := openDiskImage(d.data, d.imageType)
+				if err != nil {
+					b.Fatal(err)
+				}
+				if _, err := img.directory(); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
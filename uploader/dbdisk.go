@@ -0,0 +1,160 @@
+// Disk image indexing for the database generator.
+// Every disk image of a release is parsed by a worker pool, and its header, directory
+// and first PRG are stored in the database, so the server can list and run disks
+// without parsing them and broken images are known before anyone tries to launch them.
+package main
+
+import (
+	"fmt"
+	"os"
+	"path/filepath"
+	"sync/atomic"
+	"time"
+)
+
+// DiskInfo is the indexed content of a disk image.
+type DiskInfo struct {
+	Format      string     `json:"format,omitempty"`
+	Name        string     `json:"name,omitempty"`
+	ID          string     `json:"id,omitempty"`
+	BlocksFree  int        `json:"blocksFree,omitempty"`
+	Files       []DiskFile `json:"files,omitempty"`
+	FirstPRG    *int       `json:"firstPrg,omitempty"`    // Index of the first PRG in Files.
+	LoadAddress int        `json:"loadAddress,omitempty"` // Load address of the first PRG.
+	Error       string     `json:"error,omitempty"`       // Why the image could not be parsed.
+}
+
+// DiskFile is one directory entry of a disk image.
+type DiskFile struct {
+	Name   string `json:"name"`
+	Type   int    `json:"type"` // CBM type byte: bits 0-3 type, bit 6 locked, bit 7 closed.
+	Blocks int    `json:"blocks"`
+	Track  int    `json:"track"` // First sector of the file.
+	Sector int    `json:"sector"`
+	Error  string `json:"error,omitempty"` // PRGs only: why the file cannot be read.
+}
+
+// directoryEntry converts an indexed file back to a directory entry.
+func (f *DiskFile) directoryEntry() directoryEntry {
+	return directoryEntry{
+		fileType: byte(f.Type) & 0x0F,
+		closed:   f.Type&0x80 != 0,
+		locked:   f.Type&0x40 != 0,
+		track:    byte(f.Track),
+		sector:   byte(f.Sector),
+		filename: f.Name,
+		blocks:   f.Blocks,
+	}
+}
+
+// readDiskInfo parses a disk image of the given type. Parse failures are recorded in
+// the result rather than returned, so broken images are flagged in the database.
+// A PRG whose first sector cannot be read is flagged on its own, so the other files of
+// the image can still be run.
+func readDiskInfo(data []byte, imageType string) *DiskInfo {
+	img, err := openDiskImage(data, imageType)
+	if err != nil {
+		return &DiskInfo{Error: err.Error()}
+	}
+	entries, err := img.directory()
+	if err != nil {
+		return &DiskInfo{Format: img.format.name, Error: err.Error()}
+	}
+
+	info := &DiskInfo{Format: img.format.name, BlocksFree: img.blocksFree()}
+	info.Name, info.ID = img.header()
+	for i, e := range entries {
+		typ := int(e.fileType)
+		if e.closed {
+			typ |= 0x80
+		}
+		if e.locked {
+			typ |= 0x40
+		}
+		file := DiskFile{Name: e.filename, Type: typ, Blocks: e.blocks, Track: int(e.track), Sector: int(e.sector)}
+		if e.fileType != fileTypePRG {
+			info.Files = append(info.Files, file)
+			continue
+		}
+
+		sector, err := img.sector(int(e.track), int(e.sector))
+		if err != nil {
+			file.Error = err.Error()
+		}
+		info.Files = append(info.Files, file)
+		if info.FirstPRG == nil {
+			first := i
+			info.FirstPRG = &first
+			if err == nil {
+				// The load address is the first two bytes of the file.
+				info.LoadAddress = int(sector[2]) | int(sector[3])<<8
+			}
+		}
+	}
+	if info.FirstPRG == nil && info.Error == "" {
+		info.Error = "no PRG files"
+	}
+	return info
+}
+
+// diskIndexStats summarizes a disk indexing run.
+type diskIndexStats struct {
+	Images  int
+	Broken  int
+	Bytes   int64
+	Elapsed time.Duration
+}
+
+// String formats the stats for progress output.
+func (s diskIndexStats) String() string {
+	return fmt.Sprintf("%d images (%d broken), %d MB in %s", s.Images, s.Broken, s.Bytes>>20, s.Elapsed.Round(time.Millisecond))
+}
+
+// indexDiskImages parses all disk images of entries in parallel and stores the result in
+// their DBFile.Disk fields.
+func indexDiskImages(basePath string, entries []DBEntry) diskIndexStats {
+	start := time.Now()
+
+	var paths []string
+	var files []*DBFile
+	for i := range entries {
+		for j := range entries[i].Files {
+			if file := &entries[i].Files[j]; isDiskImageType(file.Type) {
+				paths = append(paths, filepath.Join(basePath, entries[i].Path, file.Name))
+				files = append(files, file)
+			}
+		}
+	}
+
+	var broken, bytes atomic.Int64
+	runParallel(len(files), func(i int) {
+		data, err := os.ReadFile(paths[i])
+		if err != nil {
+			files[i].Disk = &DiskInfo{Error: err.Error()}
+		} else {
+			files[i].Disk = readDiskInfo(data, files[i].Type)
+		}
+		if files[i].Disk.fileError(firstPRGFile) != "" {
+			broken.Add(1)
+		}
+		bytes.Add(int64(len(data)))
+	})
+
+	return diskIndexStats{Images: len(files), Broken: int(broken.Load()), Bytes: bytes.Load(), Elapsed: time.Since(start)}
+}
+
+// fileError returns why PRG number file of the image, or its first PRG if file is
+// firstPRGFile, cannot be run: the error of the whole image or of that file. It returns
+// "" if the file is fine or not indexed.
+func (d *DiskInfo) fileError(file int) string {
+	if d.Error != "" {
+		return d.Error
+	}
+	if file == firstPRGFile {
+		file = *d.FirstPRG
+	}
+	if file < 0 || file >= len(d.Files) || d.Files[file].Error == "" {
+		return ""
+	}
+	return fmt.Sprintf("PRG %s: %s", d.Files[file].Name, d.Files[file].Error)
+}
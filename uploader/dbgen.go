@@ -43,15 +43,20 @@ type DBEntry struct {
 	IsOnefile   bool    `json:"isOnefile,omitempty"`   // Single-file demo
 	Rating      float64 `json:"rating,omitempty"`      // CSDB rating (0 if not rated)
 	// Music-specific fields
-	Author     string `json:"author,omitempty"`     // Composer/artist name (from HVSC path)
-	Collection string `json:"collection,omitempty"` // Source collection: csdb, hvsc, 2sid, 3sid
+	Author     string   `json:"author,omitempty"`     // Composer/artist name (from HVSC path or SID header)
+	Collection string   `json:"collection,omitempty"` // Source collection: csdb, hvsc, 2sid, 3sid
+	SID        *SIDInfo `json:"sid,omitempty"`        // Header of the primary SID file
+	// Content duplicates
+	DuplicateOf *int `json:"duplicateOf,omitempty"` // ID of the first entry with an identical primary file
 }
 
 // DBFile represents a file within a release.
 type DBFile struct {
-	Name string `json:"name"`
-	Type string `json:"type"`
-	Size int64  `json:"size"`
+	Name string    `json:"name"`
+	Type string    `json:"type"`
+	Size int64     `json:"size"`
+	Hash string    `json:"hash,omitempty"` // Content hash, see hashFile.
+	Disk *DiskInfo `json:"disk,omitempty"` // Disk images only, see indexDiskImages.
 }
 
 // CrackInfo contains parsed crack/trainer information.
@@ -94,6 +99,15 @@ var (
 	versionPattern  = regexp.MustCompile(`[Vv](\d+\.?\d*)`)
 	regionPattern   = regexp.MustCompile(`\b(NTSC|PAL)\b`)
 	previewPattern  = regexp.MustCompile(`(?i)\bpreview\b`)
+	diskPattern     = regexp.MustCompile(`(\d)D\b`)
+)
+
+// Regex patterns for parsing cross-reference folder names.
+var (
+	// Ranked folders like "01. Title" or "001 - Title".
+	rankPattern = regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
+	// Rated folders like "001. (10.0) Title".
+	ratingPattern = regexp.MustCompile(`^\d+\.\s*\((\d+\.?\d*)\)\s*(.+)$`)
 )
 
 // Flag code to name mapping.
@@ -136,7 +150,6 @@ func parseCrackInfo(releaseName string) *CrackInfo {
 	}
 
 	// Check for multi-disk indicators.
-	diskPattern := regexp.MustCompile(`(\d)D\b`)
 	if diskMatch := diskPattern.FindStringSubmatch(releaseName); len(diskMatch) >= 2 {
 		info.Flags = append(info.Flags, diskMatch[1]+"disk")
 	}
@@ -185,121 +198,37 @@ func isPreview(releaseName string) bool {
 	return previewPattern.MatchString(releaseName)
 }
 
-// scanReleaseFolder scans a release folder and returns file information.
-func scanReleaseFolder(folderPath string) ([]DBFile, string, string) {
-	var files []DBFile
-	var primaryFile string
-	var fileType string
-
-	entries, err := os.ReadDir(folderPath)
-	if err != nil {
-		return nil, "", ""
-	}
-
-	// Collect all supported files.
-	for _, entry := range entries {
-		if entry.IsDir() {
-			continue
-		}
-
-		ext := filepath.Ext(entry.Name())
-		if !supportedExtensions[ext] {
-			continue
-		}
-
-		info, err := entry.Info()
-		if err != nil {
-			continue
-		}
-
-		files = append(files, DBFile{
-			Name: entry.Name(),
-			Type: strings.ToLower(strings.TrimPrefix(ext, ".")),
-			Size: info.Size(),
-		})
-	}
-
-	if len(files) == 0 {
-		return nil, "", ""
-	}
-
-	// Select primary file by priority.
-	for _, ext := range fileTypePriority {
-		for _, f := range files {
-			if strings.EqualFold("."+f.Type, ext) {
-				primaryFile = f.Name
-				fileType = f.Type
-				break
-			}
-		}
-		if primaryFile != "" {
-			break
-		}
-	}
-
-	// Fallback to first file.
-	if primaryFile == "" && len(files) > 0 {
-		primaryFile = files[0].Name
-		fileType = files[0].Type
-	}
-
-	return files, primaryFile, fileType
-}
-
 // buildTop200Map scans Top200 folder and returns a map of title -> rank.
-func buildTop200Map(basePath string) map[string]int {
+func buildTop200Map(basePath string, cache *dirCache) map[string]int {
 	top200Map := make(map[string]int)
 	top200Path := filepath.Join(basePath, "Games", "CSDB", "Top200")
-
-	entries, err := os.ReadDir(top200Path)
-	if err != nil {
-		return top200Map
-	}
-
-	rankPattern := regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
-
-	for _, entry := range entries {
-		if !entry.IsDir() {
-			continue
-		}
-
-		name := entry.Name()
-		if match := rankPattern.FindStringSubmatch(name); len(match) >= 3 {
-			rank, _ := strconv.Atoi(match[1])
-			title := strings.TrimSpace(match[2])
-			top200Map[strings.ToLower(title)] = rank
-		}
-	}
-
+	addRankedDirs(top200Map, top200Path, cache)
 	return top200Map
 }
 
 // build4kMap scans 4k folder and returns a set of titles.
-func build4kMap(basePath string) map[string]bool {
+func build4kMap(basePath string, cache *dirCache) map[string]bool {
 	fourKMap := make(map[string]bool)
 	fourKPath := filepath.Join(basePath, "Games", "CSDB", "4k")
 
-	// Walk through the 4k directory structure.
-	filepath.WalkDir(fourKPath, func(path string, d os.DirEntry, err error) error {
-		if err != nil {
-			return nil
-		}
+	// Titles are the subdirectories of each letter folder (Letter/Title),
+	// so only the letter level needs to be read.
+	letters, err := cache.readDir(fourKPath)
+	if err != nil {
+		return fourKMap
+	}
 
-		// Skip non-directories and root.
-		if !d.IsDir() || path == fourKPath {
-			return nil
+	for _, letterDir := range letters {
+		if !letterDir.IsDir() {
+			continue
 		}
-
-		rel, _ := filepath.Rel(fourKPath, path)
-		parts := strings.Split(rel, string(os.PathSeparator))
-
-		// Title is at level 2 (Letter/Title).
-		if len(parts) == 2 {
-			fourKMap[strings.ToLower(parts[1])] = true
+		titles, _ := cache.readDir(filepath.Join(fourKPath, letterDir.Name()))
+		for _, titleDir := range titles {
+			if titleDir.IsDir() {
+				fourKMap[strings.ToLower(titleDir.Name())] = true
+			}
 		}
-
-		return nil
-	})
+	}
 
 	return fourKMap
 }
@@ -307,15 +236,20 @@ func build4kMap(basePath string) map[string]bool {
 // GenerateGamesDB generates the games.json database file.
 func GenerateGamesDB(basePath, outputPath string) error {
 	fmt.Println("Scanning Games/CSDB/All...")
+	p := startPhase("dbgen.games.scan")
 
 	// Build metadata maps from Top200 and 4k folders.
-	fmt.Println("Building Top200 rank map...")
-	top200Map := buildTop200Map(basePath)
+	fmt.Println("Building Top200 rank and 4k games maps...")
+	cache := newDirCache()
+	var top200Map map[string]int
+	var fourKMap map[string]bool
+	runConcurrently(
+		func() { top200Map = buildTop200Map(basePath, cache) },
+		func() { fourKMap = build4kMap(basePath, cache) },
+	)
 	fmt.Printf("  Found %d Top200 entries\n", len(top200Map))
-
-	fmt.Println("Building 4k games map...")
-	fourKMap := build4kMap(basePath)
 	fmt.Printf("  Found %d 4k entries\n", len(fourKMap))
+	fmt.Printf("  Metadata scan: %s\n", cache.Stats())
 
 	// Scan the main Games/CSDB/All directory.
 	allPath := filepath.Join(basePath, "Games", "CSDB", "All")
@@ -324,41 +258,21 @@ func GenerateGamesDB(basePath, outputPath string) error {
 	entryID := 1
 
 	// Walk through: Letter / Range / Title / Group / ReleaseName
-	err := filepath.WalkDir(allPath, func(path string, d os.DirEntry, err error) error {
-		if err != nil {
-			return nil
-		}
-
-		if !d.IsDir() {
-			return nil
-		}
-
-		// Get relative path from All directory.
-		rel, _ := filepath.Rel(allPath, path)
-		if rel == "." {
-			return nil
-		}
-
-		parts := strings.Split(rel, string(os.PathSeparator))
-
-		// We want release folders at level 5: Letter/Range/Title/Group/ReleaseName
-		if len(parts) != 5 {
-			return nil
-		}
-
+	var stats scanStats
+	err := walkLayout(allPath, layoutGamesCSDB, &stats, func(parts []string, path string, dirEntries []os.DirEntry) {
 		// Extract metadata from path.
 		title := parts[2]       // Title folder
 		group := parts[3]       // Group folder
 		releaseName := parts[4] // Release name folder
 
-		// Scan the release folder for files.
-		files, primaryFile, fileType := scanReleaseFolder(path)
+		// Collect files from the release folder listing.
+		files, primaryFile, fileType := collectReleaseFiles(dirEntries, &stats)
 		if len(files) == 0 {
-			return nil
+			return
 		}
 
 		// Build the relative path from assembly64 root.
-		relPath := filepath.Join("Games", "CSDB", "All", rel)
+		relPath := filepath.Join("Games", "CSDB", "All", filepath.Join(parts...))
 
 		// Check Top200 rank.
 		var top200Rank *int
@@ -396,8 +310,6 @@ func GenerateGamesDB(basePath, outputPath string) error {
 		if entryID%10000 == 0 {
 			fmt.Printf("  Processed %d entries...\n", entryID-1)
 		}
-
-		return nil
 	})
 
 	if err != nil {
@@ -405,6 +317,20 @@ func GenerateGamesDB(basePath, outputPath string) error {
 	}
 
 	fmt.Printf("  Total entries: %d\n", len(entries))
+	fmt.Printf("  Scan: %s\n", stats)
+	p.setEntries(len(entries))
+	p.end()
+
+	// Parse disk image headers and directories.
+	p = startPhase("dbgen.games.disks")
+	fmt.Println("Indexing disk images...")
+	fmt.Printf("  Disks: %s\n", indexDiskImages(basePath, entries))
+	p.end()
+
+	// Hash all files and mark entries that mirror an earlier one.
+	p = startPhase("dbgen.games.hashes")
+	indexContentHashes(basePath, entries)
+	p.end()
 
 	// Build database structure.
 	db := Database{
@@ -417,6 +343,7 @@ func GenerateGamesDB(basePath, outputPath string) error {
 
 	// Write JSON file.
 	fmt.Printf("Writing %s...\n", outputPath)
+	p = startPhase("dbgen.games.write")
 
 	jsonData, err := json.Marshal(db)
 	if err != nil {
@@ -427,6 +354,9 @@ func GenerateGamesDB(basePath, outputPath string) error {
 		return fmt.Errorf("failed to write file: %w", err)
 	}
 
+	p.addBytes(int64(len(jsonData)))
+	p.end()
+
 	fmt.Printf("Done! Generated %s (%d bytes, %d entries)\n", outputPath, len(jsonData), len(entries))
 
 	return nil
@@ -438,42 +368,20 @@ func demoKey(group, title string) string {
 }
 
 // buildDemosTop200Map scans Demos/CSDB/Top200 folder and returns a map of title -> rank.
-func buildDemosTop200Map(basePath string) map[string]int {
+func buildDemosTop200Map(basePath string, cache *dirCache) map[string]int {
 	top200Map := make(map[string]int)
 	top200Path := filepath.Join(basePath, "Demos", "CSDB", "Top200")
-
-	entries, err := os.ReadDir(top200Path)
-	if err != nil {
-		return top200Map
-	}
-
-	rankPattern := regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
-
-	for _, entry := range entries {
-		if !entry.IsDir() {
-			continue
-		}
-
-		name := entry.Name()
-		if match := rankPattern.FindStringSubmatch(name); len(match) >= 3 {
-			rank, _ := strconv.Atoi(match[1])
-			title := strings.TrimSpace(match[2])
-			top200Map[strings.ToLower(title)] = rank
-		}
-	}
-
+	addRankedDirs(top200Map, top200Path, cache)
 	return top200Map
 }
 
 // buildDemosTop500Map scans Demos/CSDB/Top500 folder and returns a map of title -> rank.
-func buildDemosTop500Map(basePath string) map[string]int {
+func buildDemosTop500Map(basePath string, cache *dirCache) map[string]int {
 	top500Map := make(map[string]int)
 	top500Path := filepath.Join(basePath, "Demos", "CSDB", "Top500")
 
-	rankPattern := regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
-
 	// Top500 has subdirectories like 001-100, 101-200, etc.
-	entries, err := os.ReadDir(top500Path)
+	entries, err := cache.readDir(top500Path)
 	if err != nil {
 		return top500Map
 	}
@@ -483,24 +391,7 @@ func buildDemosTop500Map(basePath string) map[string]int {
 			continue
 		}
 
-		rangePath := filepath.Join(top500Path, rangeDir.Name())
-		demoEntries, err := os.ReadDir(rangePath)
-		if err != nil {
-			continue
-		}
-
-		for _, entry := range demoEntries {
-			if !entry.IsDir() {
-				continue
-			}
-
-			name := entry.Name()
-			if match := rankPattern.FindStringSubmatch(name); len(match) >= 3 {
-				rank, _ := strconv.Atoi(match[1])
-				title := strings.TrimSpace(match[2])
-				top500Map[strings.ToLower(title)] = rank
-			}
-		}
+		addRankedDirs(top500Map, filepath.Join(top500Path, rangeDir.Name()), cache)
 	}
 
 	return top500Map
@@ -514,13 +405,11 @@ type DemoYearInfo struct {
 
 // buildDemosYearMap scans Year/ and Year-top20/ folders.
 // Returns map of group+title -> DemoYearInfo.
-func buildDemosYearMap(basePath string) map[string]DemoYearInfo {
+func buildDemosYearMap(basePath string, cache *dirCache) map[string]DemoYearInfo {
 	yearMap := make(map[string]DemoYearInfo)
-	rankPattern := regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
-
 	// Scan Year/ directory: Year/{Year}/{Group}/{Title}/
 	yearPath := filepath.Join(basePath, "Demos", "CSDB", "Year")
-	if years, err := os.ReadDir(yearPath); err == nil {
+	if years, err := cache.readDir(yearPath); err == nil {
 		for _, yearDir := range years {
 			if !yearDir.IsDir() {
 				continue
@@ -531,7 +420,7 @@ func buildDemosYearMap(basePath string) map[string]DemoYearInfo {
 			}
 
 			groupsPath := filepath.Join(yearPath, yearDir.Name())
-			groups, err := os.ReadDir(groupsPath)
+			groups, err := cache.readDir(groupsPath)
 			if err != nil {
 				continue
 			}
@@ -543,7 +432,7 @@ func buildDemosYearMap(basePath string) map[string]DemoYearInfo {
 				group := groupDir.Name()
 
 				titlesPath := filepath.Join(groupsPath, group)
-				titles, err := os.ReadDir(titlesPath)
+				titles, err := cache.readDir(titlesPath)
 				if err != nil {
 					continue
 				}
@@ -564,7 +453,7 @@ func buildDemosYearMap(basePath string) map[string]DemoYearInfo {
 
 	// Scan Year-top20/ directory: Year-top20/{Year}/{Rank. Title}/
 	yearTop20Path := filepath.Join(basePath, "Demos", "CSDB", "Year-top20")
-	if years, err := os.ReadDir(yearTop20Path); err == nil {
+	if years, err := cache.readDir(yearTop20Path); err == nil {
 		for _, yearDir := range years {
 			if !yearDir.IsDir() {
 				continue
@@ -575,7 +464,7 @@ func buildDemosYearMap(basePath string) map[string]DemoYearInfo {
 			}
 
 			demosPath := filepath.Join(yearTop20Path, yearDir.Name())
-			demos, err := os.ReadDir(demosPath)
+			demos, err := cache.readDir(demosPath)
 			if err != nil {
 				continue
 			}
@@ -589,9 +478,7 @@ func buildDemosYearMap(basePath string) map[string]DemoYearInfo {
 					rank, _ := strconv.Atoi(match[1])
 					title := strings.TrimSpace(match[2])
 					// Store by title only (we don't have group here)
-					titleKey := strings.ToLower(title)
-					// We'll need to match this later by title only
-					yearMap["_title_"+titleKey] = DemoYearInfo{Year: year, YearRank: rank}
+					yearMap[demoKey("", title)] = DemoYearInfo{Year: year, YearRank: rank}
 				}
 			}
 		}
@@ -610,13 +497,11 @@ type DemoPartyInfo struct {
 
 // buildDemosPartyMap scans Year-party-group/ folder.
 // Returns map of group+title -> DemoPartyInfo.
-func buildDemosPartyMap(basePath string) map[string]DemoPartyInfo {
+func buildDemosPartyMap(basePath string, cache *dirCache) map[string]DemoPartyInfo {
 	partyMap := make(map[string]DemoPartyInfo)
-	rankPattern := regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
-
 	// Year-party-group/{Year}/{Party}/{Competition?}/{Rank. Group}/
 	baseDirPath := filepath.Join(basePath, "Demos", "CSDB", "Year-party-group")
-	years, err := os.ReadDir(baseDirPath)
+	years, err := cache.readDir(baseDirPath)
 	if err != nil {
 		return partyMap
 	}
@@ -631,7 +516,7 @@ func buildDemosPartyMap(basePath string) map[string]DemoPartyInfo {
 		}
 
 		yearPath := filepath.Join(baseDirPath, yearDir.Name())
-		parties, _ := os.ReadDir(yearPath)
+		parties, _ := cache.readDir(yearPath)
 
 		for _, partyDir := range parties {
 			if !partyDir.IsDir() {
@@ -641,7 +526,7 @@ func buildDemosPartyMap(basePath string) map[string]DemoPartyInfo {
 			partyPath := filepath.Join(yearPath, partyName)
 
 			// Check if this party has competition subdirectories or direct group entries
-			partyContents, _ := os.ReadDir(partyPath)
+			partyContents, _ := cache.readDir(partyPath)
 			for _, content := range partyContents {
 				if !content.IsDir() {
 					continue
@@ -655,7 +540,7 @@ func buildDemosPartyMap(basePath string) map[string]DemoPartyInfo {
 					groupPath := filepath.Join(partyPath, content.Name())
 
 					// Scan for titles in this group folder
-					titles, _ := os.ReadDir(groupPath)
+					titles, _ := cache.readDir(groupPath)
 					for _, titleDir := range titles {
 						if titleDir.IsDir() {
 							key := demoKey(group, titleDir.Name())
@@ -670,7 +555,7 @@ func buildDemosPartyMap(basePath string) map[string]DemoPartyInfo {
 					// This might be a competition subdir (e.g., "C64 Demo")
 					competition := content.Name()
 					compPath := filepath.Join(partyPath, competition)
-					groupEntries, _ := os.ReadDir(compPath)
+					groupEntries, _ := cache.readDir(compPath)
 
 					for _, groupEntry := range groupEntries {
 						if !groupEntry.IsDir() {
@@ -682,7 +567,7 @@ func buildDemosPartyMap(basePath string) map[string]DemoPartyInfo {
 							groupPath := filepath.Join(compPath, groupEntry.Name())
 
 							// Scan for titles (usually files directly)
-							titles, _ := os.ReadDir(groupPath)
+							titles, _ := cache.readDir(groupPath)
 							for _, titleEntry := range titles {
 								if titleEntry.IsDir() {
 									key := demoKey(group, titleEntry.Name())
@@ -718,12 +603,12 @@ func buildDemosPartyMap(basePath string) map[string]DemoPartyInfo {
 }
 
 // buildDemosOnefileMap scans Onefile/ folder and returns set of group+title.
-func buildDemosOnefileMap(basePath string) map[string]bool {
+func buildDemosOnefileMap(basePath string, cache *dirCache) map[string]bool {
 	onefileMap := make(map[string]bool)
 
 	// Onefile/{Letter}/{Group}/{Title}/
 	onefilePath := filepath.Join(basePath, "Demos", "CSDB", "Onefile")
-	letters, err := os.ReadDir(onefilePath)
+	letters, err := cache.readDir(onefilePath)
 	if err != nil {
 		return onefileMap
 	}
@@ -734,7 +619,7 @@ func buildDemosOnefileMap(basePath string) map[string]bool {
 		}
 
 		letterPath := filepath.Join(onefilePath, letterDir.Name())
-		groups, _ := os.ReadDir(letterPath)
+		groups, _ := cache.readDir(letterPath)
 
 		for _, groupDir := range groups {
 			if !groupDir.IsDir() {
@@ -742,7 +627,7 @@ func buildDemosOnefileMap(basePath string) map[string]bool {
 			}
 			group := groupDir.Name()
 			groupPath := filepath.Join(letterPath, group)
-			titles, _ := os.ReadDir(groupPath)
+			titles, _ := cache.readDir(groupPath)
 
 			for _, titleDir := range titles {
 				if titleDir.IsDir() {
@@ -763,15 +648,12 @@ type DemoRatingInfo struct {
 }
 
 // buildDemosRatingMap scans Rating-year-group/ and top200 folders with ratings.
-func buildDemosRatingMap(basePath string) map[string]DemoRatingInfo {
+func buildDemosRatingMap(basePath string, cache *dirCache) map[string]DemoRatingInfo {
 	ratingMap := make(map[string]DemoRatingInfo)
 
-	// Parse rating from folder names like "001. (10.0) Title"
-	ratingPattern := regexp.MustCompile(`^\d+\.\s*\((\d+\.?\d*)\)\s*(.+)$`)
-
 	// Scan Onefile-top200 for ratings
 	onefileTop200Path := filepath.Join(basePath, "Demos", "CSDB", "Onefile-top200")
-	if entries, err := os.ReadDir(onefileTop200Path); err == nil {
+	if entries, err := cache.readDir(onefileTop200Path); err == nil {
 		for _, entry := range entries {
 			if !entry.IsDir() {
 				continue
@@ -779,14 +661,14 @@ func buildDemosRatingMap(basePath string) map[string]DemoRatingInfo {
 			if match := ratingPattern.FindStringSubmatch(entry.Name()); len(match) >= 3 {
 				rating, _ := strconv.ParseFloat(match[1], 64)
 				title := strings.TrimSpace(match[2])
-				ratingMap["_title_"+strings.ToLower(title)] = DemoRatingInfo{Rating: rating}
+				ratingMap[demoKey("", title)] = DemoRatingInfo{Rating: rating}
 			}
 		}
 	}
 
 	// Scan Misc-top200 for ratings
 	miscTop200Path := filepath.Join(basePath, "Demos", "CSDB", "Misc-top200")
-	if entries, err := os.ReadDir(miscTop200Path); err == nil {
+	if entries, err := cache.readDir(miscTop200Path); err == nil {
 		for _, entry := range entries {
 			if !entry.IsDir() {
 				continue
@@ -794,14 +676,14 @@ func buildDemosRatingMap(basePath string) map[string]DemoRatingInfo {
 			if match := ratingPattern.FindStringSubmatch(entry.Name()); len(match) >= 3 {
 				rating, _ := strconv.ParseFloat(match[1], 64)
 				title := strings.TrimSpace(match[2])
-				ratingMap["_title_"+strings.ToLower(title)] = DemoRatingInfo{Rating: rating}
+				ratingMap[demoKey("", title)] = DemoRatingInfo{Rating: rating}
 			}
 		}
 	}
 
 	// Scan Rating-year-group: {Rating}/{Year}/{Group}/{Title}
 	ratingYearPath := filepath.Join(basePath, "Demos", "CSDB", "Rating-year-group")
-	if ratings, err := os.ReadDir(ratingYearPath); err == nil {
+	if ratings, err := cache.readDir(ratingYearPath); err == nil {
 		for _, ratingDir := range ratings {
 			if !ratingDir.IsDir() {
 				continue
@@ -812,7 +694,7 @@ func buildDemosRatingMap(basePath string) map[string]DemoRatingInfo {
 			}
 
 			ratingPath := filepath.Join(ratingYearPath, ratingDir.Name())
-			years, _ := os.ReadDir(ratingPath)
+			years, _ := cache.readDir(ratingPath)
 
 			for _, yearDir := range years {
 				if !yearDir.IsDir() {
@@ -824,7 +706,7 @@ func buildDemosRatingMap(basePath string) map[string]DemoRatingInfo {
 				}
 
 				yearPath := filepath.Join(ratingPath, yearDir.Name())
-				groups, _ := os.ReadDir(yearPath)
+				groups, _ := cache.readDir(yearPath)
 
 				for _, groupDir := range groups {
 					if !groupDir.IsDir() {
@@ -832,7 +714,7 @@ func buildDemosRatingMap(basePath string) map[string]DemoRatingInfo {
 					}
 					group := groupDir.Name()
 					groupPath := filepath.Join(yearPath, group)
-					titles, _ := os.ReadDir(groupPath)
+					titles, _ := cache.readDir(groupPath)
 
 					for _, titleDir := range titles {
 						if titleDir.IsDir() {
@@ -851,33 +733,13 @@ func buildDemosRatingMap(basePath string) map[string]DemoRatingInfo {
 // GenerateDemosDB generates the demos JSON database file.
 func GenerateDemosDB(basePath, outputPath string) error {
 	fmt.Println("Scanning Demos/CSDB/All...")
+	p := startPhase("dbgen.demos.scan")
 
-	// Build metadata maps from various folders.
+	// Build the merged metadata table from the cross-reference folders.
 	fmt.Println("Building demos metadata maps...")
-
-	fmt.Print("  Top200... ")
-	top200Map := buildDemosTop200Map(basePath)
-	fmt.Printf("%d entries\n", len(top200Map))
-
-	fmt.Print("  Top500... ")
-	top500Map := buildDemosTop500Map(basePath)
-	fmt.Printf("%d entries\n", len(top500Map))
-
-	fmt.Print("  Year data... ")
-	yearMap := buildDemosYearMap(basePath)
-	fmt.Printf("%d entries\n", len(yearMap))
-
-	fmt.Print("  Party data... ")
-	partyMap := buildDemosPartyMap(basePath)
-	fmt.Printf("%d entries\n", len(partyMap))
-
-	fmt.Print("  Onefile... ")
-	onefileMap := buildDemosOnefileMap(basePath)
-	fmt.Printf("%d entries\n", len(onefileMap))
-
-	fmt.Print("  Ratings... ")
-	ratingMap := buildDemosRatingMap(basePath)
-	fmt.Printf("%d entries\n", len(ratingMap))
+	cache := newDirCache()
+	xref := buildDemosMetadata(basePath, cache)
+	fmt.Printf("  Metadata scan: %s\n", cache.Stats())
 
 	// Scan the main Demos/CSDB/All directory.
 	// Structure: All/{Letter}/{Group}/{Title}/
@@ -886,72 +748,51 @@ func GenerateDemosDB(basePath, outputPath string) error {
 	var entries []DBEntry
 	entryID := 1
 
-	err := filepath.WalkDir(allPath, func(path string, d os.DirEntry, err error) error {
-		if err != nil {
-			return nil
-		}
-
-		if !d.IsDir() {
-			return nil
-		}
-
-		// Get relative path from All directory.
-		rel, _ := filepath.Rel(allPath, path)
-		if rel == "." {
-			return nil
-		}
-
-		parts := strings.Split(rel, string(os.PathSeparator))
-
-		// We want demo folders at level 3: Letter/Group/Title
-		if len(parts) != 3 {
-			return nil
-		}
-
+	var stats scanStats
+	err := walkLayout(allPath, layoutDemosCSDB, &stats, func(parts []string, path string, dirEntries []os.DirEntry) {
 		group := parts[1] // Group folder
 		title := parts[2] // Title folder
 
-		// Scan the demo folder for files.
-		files, primaryFile, fileType := scanReleaseFolder(path)
+		// Collect files from the demo folder listing.
+		files, primaryFile, fileType := collectReleaseFiles(dirEntries, &stats)
 		if len(files) == 0 {
-			return nil
+			return
 		}
 
 		// Build the relative path from assembly64 root.
-		relPath := filepath.Join("Demos", "CSDB", "All", rel)
+		relPath := filepath.Join("Demos", "CSDB", "All", filepath.Join(parts...))
 
-		// Look up metadata from cross-reference maps.
-		key := demoKey(group, title)
-		titleKey := "_title_" + strings.ToLower(title)
+		// Look up metadata from the cross-reference table, both by group+title
+		// and by title only.
+		meta := xref[demoKey(group, title)]
+		titleMeta := xref[demoKey("", title)]
 
-		// Top200 rank (by title)
+		// Top200 and Top500 rank (by title)
 		var top200Rank *int
-		if rank, ok := top200Map[strings.ToLower(title)]; ok {
-			top200Rank = &rank
+		if titleMeta.Top200Rank > 0 {
+			top200Rank = &titleMeta.Top200Rank
 		}
-
-		// Top500 rank (by title)
 		var top500Rank *int
-		if rank, ok := top500Map[strings.ToLower(title)]; ok {
-			top500Rank = &rank
+		if titleMeta.Top500Rank > 0 {
+			top500Rank = &titleMeta.Top500Rank
 		}
 
 		// Year info
 		var year *int
 		var yearRank *int
-		if info, ok := yearMap[key]; ok {
-			year = &info.Year
-			if info.YearRank > 0 {
-				yearRank = &info.YearRank
+		if meta.HasYear {
+			year = &meta.Year
+			if meta.YearRank > 0 {
+				yearRank = &meta.YearRank
 			}
 		}
 		// Also check by title only for year-top20
-		if info, ok := yearMap[titleKey]; ok {
+		if titleMeta.HasYear {
 			if year == nil {
-				year = &info.Year
+				year = &titleMeta.Year
 			}
-			if info.YearRank > 0 {
-				yearRank = &info.YearRank
+			if titleMeta.YearRank > 0 {
+				yearRank = &titleMeta.YearRank
 			}
 		}
 
@@ -959,7 +800,7 @@ func GenerateDemosDB(basePath, outputPath string) error {
 		var party string
 		var partyRank *int
 		var competition string
-		if info, ok := partyMap[key]; ok {
+		if info := meta.Party; info != nil {
 			party = info.Party
 			if info.PartyRank > 0 {
 				partyRank = &info.PartyRank
@@ -971,19 +812,19 @@ func GenerateDemosDB(basePath, outputPath string) error {
 		}
 
 		// Onefile flag
-		isOnefile := onefileMap[key]
+		isOnefile := meta.IsOnefile
 
 		// Rating
 		var rating float64
-		if info, ok := ratingMap[key]; ok {
-			rating = info.Rating
-			if year == nil && info.Year > 0 {
-				year = &info.Year
+		if meta.HasRating {
+			rating = meta.Rating
+			if year == nil && meta.RatingYear > 0 {
+				year = &meta.RatingYear
 			}
 		}
 		// Also check by title only for ratings
-		if info, ok := ratingMap[titleKey]; ok && rating == 0 {
-			rating = info.Rating
+		if titleMeta.HasRating && rating == 0 {
+			rating = titleMeta.Rating
 		}
 
 		entry := DBEntry{
@@ -1012,8 +853,6 @@ func GenerateDemosDB(basePath, outputPath string) error {
 		if entryID%10000 == 0 {
 			fmt.Printf("  Processed %d entries...\n", entryID-1)
 		}
-
-		return nil
 	})
 
 	if err != nil {
@@ -1021,6 +860,20 @@ func GenerateDemosDB(basePath, outputPath string) error {
 	}
 
 	fmt.Printf("  Total entries: %d\n", len(entries))
+	fmt.Printf("  Scan: %s\n", stats)
+	p.setEntries(len(entries))
+	p.end()
+
+	// Parse disk image headers and directories.
+	p = startPhase("dbgen.demos.disks")
+	fmt.Println("Indexing disk images...")
+	fmt.Printf("  Disks: %s\n", indexDiskImages(basePath, entries))
+	p.end()
+
+	// Hash all files and mark entries that mirror an earlier one.
+	p = startPhase("dbgen.demos.hashes")
+	indexContentHashes(basePath, entries)
+	p.end()
 
 	// Build database structure.
 	db := Database{
@@ -1033,6 +886,7 @@ func GenerateDemosDB(basePath, outputPath string) error {
 
 	// Write JSON file.
 	fmt.Printf("Writing %s...\n", outputPath)
+	p = startPhase("dbgen.demos.write")
 
 	jsonData, err := json.Marshal(db)
 	if err != nil {
@@ -1043,36 +897,19 @@ func GenerateDemosDB(basePath, outputPath string) error {
 		return fmt.Errorf("failed to write file: %w", err)
 	}
 
+	p.addBytes(int64(len(jsonData)))
+	p.end()
+
 	fmt.Printf("Done! Generated %s (%d bytes, %d entries)\n", outputPath, len(jsonData), len(entries))
 
 	return nil
 }
 
 // buildMusicTop200Map scans Music/CSDB/Top200 folder and returns a map of title -> rank.
-func buildMusicTop200Map(basePath string) map[string]int {
+func buildMusicTop200Map(basePath string, cache *dirCache) map[string]int {
 	top200Map := make(map[string]int)
 	top200Path := filepath.Join(basePath, "Music", "CSDB", "Top200")
-
-	entries, err := os.ReadDir(top200Path)
-	if err != nil {
-		return top200Map
-	}
-
-	rankPattern := regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
-
-	for _, entry := range entries {
-		if !entry.IsDir() {
-			continue
-		}
-
-		name := entry.Name()
-		if match := rankPattern.FindStringSubmatch(name); len(match) >= 3 {
-			rank, _ := strconv.Atoi(match[1])
-			title := strings.TrimSpace(match[2])
-			top200Map[strings.ToLower(title)] = rank
-		}
-	}
-
+	addRankedDirs(top200Map, top200Path, cache)
 	return top200Map
 }
 
@@ -1086,13 +923,11 @@ type MusicPartyInfo struct {
 
 // buildMusicPartyMap scans Music/CSDB/Year-party-group folder.
 // Returns map of title -> MusicPartyInfo.
-func buildMusicPartyMap(basePath string) map[string]MusicPartyInfo {
+func buildMusicPartyMap(basePath string, cache *dirCache) map[string]MusicPartyInfo {
 	partyMap := make(map[string]MusicPartyInfo)
-	rankPattern := regexp.MustCompile(`^(\d+)\s*[-_\.]\s*(.+)$`)
-
 	// Year-party-group/{Year}/{Party}/{Competition?}/{Rank. Title}/
 	baseDirPath := filepath.Join(basePath, "Music", "CSDB", "Year-party-group")
-	years, err := os.ReadDir(baseDirPath)
+	years, err := cache.readDir(baseDirPath)
 	if err != nil {
 		return partyMap
 	}
@@ -1107,7 +942,7 @@ func buildMusicPartyMap(basePath string) map[string]MusicPartyInfo {
 		}
 
 		yearPath := filepath.Join(baseDirPath, yearDir.Name())
-		parties, _ := os.ReadDir(yearPath)
+		parties, _ := cache.readDir(yearPath)
 
 		for _, partyDir := range parties {
 			if !partyDir.IsDir() {
@@ -1117,7 +952,7 @@ func buildMusicPartyMap(basePath string) map[string]MusicPartyInfo {
 			partyPath := filepath.Join(yearPath, partyName)
 
 			// Check contents (either ranked titles directly, or competition subdirs)
-			partyContents, _ := os.ReadDir(partyPath)
+			partyContents, _ := cache.readDir(partyPath)
 			for _, content := range partyContents {
 				if !content.IsDir() {
 					continue
@@ -1136,7 +971,7 @@ func buildMusicPartyMap(basePath string) map[string]MusicPartyInfo {
 					// This might be a competition subdir (e.g., "C64 Music")
 					competition := content.Name()
 					compPath := filepath.Join(partyPath, competition)
-					titleEntries, _ := os.ReadDir(compPath)
+					titleEntries, _ := cache.readDir(compPath)
 
 					for _, titleEntry := range titleEntries {
 						if !titleEntry.IsDir() {
@@ -1163,49 +998,28 @@ func buildMusicPartyMap(basePath string) map[string]MusicPartyInfo {
 
 // scanMusicCSDB scans the Music/CSDB/All directory.
 // Structure: All/{Letter}/{Title}/
-func scanMusicCSDB(basePath string, entries *[]DBEntry, entryID *int, top200Map map[string]int, partyMap map[string]MusicPartyInfo) error {
+func scanMusicCSDB(basePath string, entries *[]DBEntry, entryID *int, xref map[string]musicMeta, stats *scanStats) error {
 	allPath := filepath.Join(basePath, "Music", "CSDB", "All")
 
-	return filepath.WalkDir(allPath, func(path string, d os.DirEntry, err error) error {
-		if err != nil {
-			return nil
-		}
-
-		if !d.IsDir() {
-			return nil
-		}
-
-		// Get relative path from All directory.
-		rel, _ := filepath.Rel(allPath, path)
-		if rel == "." {
-			return nil
-		}
-
-		parts := strings.Split(rel, string(os.PathSeparator))
-
-		// We want music folders at level 2: Letter/Title
-		if len(parts) != 2 {
-			return nil
-		}
-
+	return walkLayout(allPath, layoutMusicCSDB, stats, func(parts []string, path string, dirEntries []os.DirEntry) {
 		title := parts[1] // Title folder
 
-		// Scan the folder for files.
-		files, primaryFile, fileType := scanReleaseFolder(path)
+		// Collect files from the folder listing.
+		files, primaryFile, fileType := collectReleaseFiles(dirEntries, stats)
 		if len(files) == 0 {
-			return nil
+			return
 		}
 
 		// Build the relative path from assembly64 root.
-		relPath := filepath.Join("Music", "CSDB", "All", rel)
+		relPath := filepath.Join("Music", "CSDB", "All", filepath.Join(parts...))
 
-		// Look up metadata from cross-reference maps.
-		titleKey := strings.ToLower(title)
+		// Look up metadata from the cross-reference table.
+		meta := xref[strings.ToLower(title)]
 
 		// Top200 rank
 		var top200Rank *int
-		if rank, ok := top200Map[titleKey]; ok {
-			top200Rank = &rank
+		if meta.Top200Rank > 0 {
+			top200Rank = &meta.Top200Rank
 		}
 
 		// Party info
@@ -1213,7 +1027,7 @@ func scanMusicCSDB(basePath string, entries *[]DBEntry, entryID *int, top200Map
 		var partyRank *int
 		var competition string
 		var year *int
-		if info, ok := partyMap[titleKey]; ok {
+		if info := meta.Party; info != nil {
 			party = info.Party
 			if info.PartyRank > 0 {
 				partyRank = &info.PartyRank
@@ -1246,49 +1060,26 @@ func scanMusicCSDB(basePath string, entries *[]DBEntry, entryID *int, top200Map
 		if *entryID%10000 == 0 {
 			fmt.Printf("  Processed %d entries...\n", *entryID-1)
 		}
-
-		return nil
 	})
 }
 
 // scanMusicHVSC scans the Music/HVSC/Music directory.
 // Structure: Music/{Letter}/{Author}/{Title}/
-func scanMusicHVSC(basePath string, entries *[]DBEntry, entryID *int) error {
+func scanMusicHVSC(basePath string, entries *[]DBEntry, entryID *int, stats *scanStats) error {
 	hvscPath := filepath.Join(basePath, "Music", "HVSC", "Music")
 
-	return filepath.WalkDir(hvscPath, func(path string, d os.DirEntry, err error) error {
-		if err != nil {
-			return nil
-		}
-
-		if !d.IsDir() {
-			return nil
-		}
-
-		// Get relative path from Music directory.
-		rel, _ := filepath.Rel(hvscPath, path)
-		if rel == "." {
-			return nil
-		}
-
-		parts := strings.Split(rel, string(os.PathSeparator))
-
-		// We want music folders at level 3: Letter/Author/Title
-		if len(parts) != 3 {
-			return nil
-		}
-
+	return walkLayout(hvscPath, layoutMusicHVSC, stats, func(parts []string, path string, dirEntries []os.DirEntry) {
 		author := parts[1] // Author folder
 		title := parts[2]  // Title folder
 
-		// Scan the folder for files.
-		files, primaryFile, fileType := scanReleaseFolder(path)
+		// Collect files from the folder listing.
+		files, primaryFile, fileType := collectReleaseFiles(dirEntries, stats)
 		if len(files) == 0 {
-			return nil
+			return
 		}
 
 		// Build the relative path from assembly64 root.
-		relPath := filepath.Join("Music", "HVSC", "Music", rel)
+		relPath := filepath.Join("Music", "HVSC", "Music", filepath.Join(parts...))
 
 		entry := DBEntry{
 			ID:          *entryID,
@@ -1308,42 +1099,23 @@ func scanMusicHVSC(basePath string, entries *[]DBEntry, entryID *int) error {
 		if *entryID%10000 == 0 {
 			fmt.Printf("  Processed %d entries...\n", *entryID-1)
 		}
-
-		return nil
 	})
 }
 
 // scanMusicSidCollection scans 2sid-collection or 3sid-collection directories.
 // Structure: {Letter}/{Author}/{Title}/ or {Letter}/{Title}/
-func scanMusicSidCollection(basePath, collectionName, collectionID string, entries *[]DBEntry, entryID *int) error {
+func scanMusicSidCollection(basePath, collectionName, collectionID string, entries *[]DBEntry, entryID *int, stats *scanStats) error {
 	collPath := filepath.Join(basePath, "Music", collectionName)
 
-	return filepath.WalkDir(collPath, func(path string, d os.DirEntry, err error) error {
-		if err != nil {
-			return nil
-		}
-
-		if !d.IsDir() {
-			return nil
-		}
-
-		// Get relative path from collection directory.
-		rel, _ := filepath.Rel(collPath, path)
-		if rel == "." {
-			return nil
-		}
-
-		parts := strings.Split(rel, string(os.PathSeparator))
-
-		// These collections can have either:
-		// - Level 2: Letter/Title (flat)
-		// - Level 3: Letter/Author/Title (like HVSC)
-		// We scan files in folders that have supported files.
-
-		// Scan the folder for files.
-		files, primaryFile, fileType := scanReleaseFolder(path)
+	// These collections can have either:
+	// - Level 2: Letter/Title (flat)
+	// - Level 3: Letter/Author/Title (like HVSC)
+	// Folders at either level that contain supported files become entries.
+	return walkLayout(collPath, layoutSidCollected, stats, func(parts []string, path string, dirEntries []os.DirEntry) {
+		// Collect files from the folder listing.
+		files, primaryFile, fileType := collectReleaseFiles(dirEntries, stats)
 		if len(files) == 0 {
-			return nil
+			return
 		}
 
 		// Determine title and author based on path depth.
@@ -1351,17 +1123,14 @@ func scanMusicSidCollection(basePath, collectionName, collectionID string, entri
 		if len(parts) == 2 {
 			// Letter/Title
 			title = parts[1]
-		} else if len(parts) == 3 {
+		} else {
 			// Letter/Author/Title
 			author = parts[1]
 			title = parts[2]
-		} else {
-			// Skip other depths
-			return nil
 		}
 
 		// Build the relative path from assembly64 root.
-		relPath := filepath.Join("Music", collectionName, rel)
+		relPath := filepath.Join("Music", collectionName, filepath.Join(parts...))
 
 		entry := DBEntry{
 			ID:          *entryID,
@@ -1377,32 +1146,27 @@ func scanMusicSidCollection(basePath, collectionName, collectionID string, entri
 
 		*entries = append(*entries, entry)
 		*entryID++
-
-		return nil
 	})
 }
 
 // GenerateMusicDB generates the music JSON database file.
 func GenerateMusicDB(basePath, outputPath string) error {
 	fmt.Println("Scanning Music collections...")
+	p := startPhase("dbgen.music.scan")
 
-	// Build metadata maps from CSDB folders.
+	// Build the merged metadata table from CSDB folders.
 	fmt.Println("Building music metadata maps...")
-
-	fmt.Print("  Top200... ")
-	top200Map := buildMusicTop200Map(basePath)
-	fmt.Printf("%d entries\n", len(top200Map))
-
-	fmt.Print("  Party data... ")
-	partyMap := buildMusicPartyMap(basePath)
-	fmt.Printf("%d entries\n", len(partyMap))
+	cache := newDirCache()
+	xref := buildMusicMetadata(basePath, cache)
+	fmt.Printf("  Metadata scan: %s\n", cache.Stats())
 
 	var entries []DBEntry
 	entryID := 1
+	var stats scanStats
 
 	// Scan CSDB collection.
 	fmt.Println("Scanning Music/CSDB/All...")
-	if err := scanMusicCSDB(basePath, &entries, &entryID, top200Map, partyMap); err != nil {
+	if err := scanMusicCSDB(basePath, &entries, &entryID, xref, &stats); err != nil {
 		fmt.Printf("  Warning: CSDB scan error: %v\n", err)
 	}
 	csdbCount := len(entries)
@@ -1410,7 +1174,7 @@ func GenerateMusicDB(basePath, outputPath string) error {
 
 	// Scan HVSC collection.
 	fmt.Println("Scanning Music/HVSC/Music...")
-	if err := scanMusicHVSC(basePath, &entries, &entryID); err != nil {
+	if err := scanMusicHVSC(basePath, &entries, &entryID, &stats); err != nil {
 		fmt.Printf("  Warning: HVSC scan error: %v\n", err)
 	}
 	hvscCount := len(entries) - csdbCount
@@ -1419,7 +1183,7 @@ func GenerateMusicDB(basePath, outputPath string) error {
 	// Scan 2sid-collection.
 	fmt.Println("Scanning Music/2sid-collection...")
 	prevCount := len(entries)
-	if err := scanMusicSidCollection(basePath, "2sid-collection", "2sid", &entries, &entryID); err != nil {
+	if err := scanMusicSidCollection(basePath, "2sid-collection", "2sid", &entries, &entryID, &stats); err != nil {
 		fmt.Printf("  Warning: 2sid-collection scan error: %v\n", err)
 	}
 	fmt.Printf("  2sid entries: %d\n", len(entries)-prevCount)
@@ -1427,12 +1191,26 @@ func GenerateMusicDB(basePath, outputPath string) error {
 	// Scan 3sid-collection.
 	fmt.Println("Scanning Music/3sid-collection...")
 	prevCount = len(entries)
-	if err := scanMusicSidCollection(basePath, "3sid-collection", "3sid", &entries, &entryID); err != nil {
+	if err := scanMusicSidCollection(basePath, "3sid-collection", "3sid", &entries, &entryID, &stats); err != nil {
 		fmt.Printf("  Warning: 3sid-collection scan error: %v\n", err)
 	}
 	fmt.Printf("  3sid entries: %d\n", len(entries)-prevCount)
 
 	fmt.Printf("  Total entries: %d\n", len(entries))
+	fmt.Printf("  Scan: %s\n", stats)
+	p.setEntries(len(entries))
+	p.end()
+
+	// Read the SID headers for composer, release and chip metadata.
+	p = startPhase("dbgen.music.sids")
+	fmt.Println("Indexing SID headers...")
+	fmt.Printf("  SIDs: %s\n", indexSIDHeaders(basePath, entries))
+	p.end()
+
+	// Hash all files and mark entries that mirror an earlier one.
+	p = startPhase("dbgen.music.hashes")
+	indexContentHashes(basePath, entries)
+	p.end()
 
 	// Build database structure.
 	db := Database{
@@ -1445,6 +1223,7 @@ func GenerateMusicDB(basePath, outputPath string) error {
 
 	// Write JSON file.
 	fmt.Printf("Writing %s...\n", outputPath)
+	p = startPhase("dbgen.music.write")
 
 	jsonData, err := json.Marshal(db)
 	if err != nil {
@@ -1455,6 +1234,9 @@ func GenerateMusicDB(basePath, outputPath string) error {
 		return fmt.Errorf("failed to write file: %w", err)
 	}
 
+	p.addBytes(int64(len(jsonData)))
+	p.end()
+
 	fmt.Printf("Done! Generated %s (%d bytes, %d entries)\n", outputPath, len(jsonData), len(entries))
 
 	return nil
@@ -0,0 +1,259 @@
+// Content hashing and duplicate detection.
+// dbgen hashes every release file with a worker pool, caching hashes on disk by path,
+// size and modification time so a regeneration only reads files that changed. Entries
+// whose primary file is byte-identical to an earlier entry's are mirrors, which share
+// caches at runtime and can be hidden in the UI.
+package main
+
+import (
+	"crypto/sha256"
+	"encoding/hex"
+	"encoding/json"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// hashCacheFile is the name of the persistent hash cache in the assembly64 directory.
+const hashCacheFile = "c64uploader_hashes.json"
+
+// hashCacheEntry is the cached hash of one file version.
+type hashCacheEntry struct {
+	Size    int64  `json:"size"`
+	ModTime int64  `json:"mtime"` // Unix nanoseconds.
+	Hash    string `json:"hash"`
+}
+
+// hashCache maps relative file paths to their cached hashes.
+type hashCache struct {
+	mu      sync.Mutex
+	path    string
+	entries map[string]hashCacheEntry
+}
+
+// loadHashCache reads the hash cache of an assembly64 directory. A missing or
+// unreadable cache starts empty.
+func loadHashCache(basePath string) *hashCache {
+	c := &hashCache{path: filepath.Join(basePath, hashCacheFile), entries: make(map[string]hashCacheEntry)}
+	if data, err := os.ReadFile(c.path); err == nil {
+		if err := json.Unmarshal(data, &c.entries); err != nil {
+			fmt.Printf("  Warning: ignoring corrupt hash cache: %v\n", err)
+			c.entries = make(map[string]hashCacheEntry)
+		}
+	}
+	return c
+}
+
+// lookup returns the cached hash of a file if its size and mtime are unchanged.
+func (c *hashCache) lookup(relPath string, info os.FileInfo) (string, bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	e, ok := c.entries[relPath]
+	if !ok || e.Size != info.Size() || e.ModTime != info.ModTime().UnixNano() {
+		return "", false
+	}
+	return e.Hash, true
+}
+
+// store records the hash of a file version.
+func (c *hashCache) store(relPath string, info os.FileInfo, hash string) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.entries[relPath] = hashCacheEntry{Size: info.Size(), ModTime: info.ModTime().UnixNano(), Hash: hash}
+}
+
+// prune drops the cached hashes of files that were not hashed in this run, i.e. renamed
+// or deleted ones, and returns how many were dropped. Only files under the top-level
+// directories of seen are considered, as the others belong to categories that this
+// run did not generate.
+func (c *hashCache) prune(seen []string) int {
+	keep := make(map[string]bool, len(seen))
+	roots := make(map[string]bool)
+	for _, p := range seen {
+		keep[p] = true
+		root, _, _ := strings.Cut(p, string(filepath.Separator))
+		roots[root] = true
+	}
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	dropped := 0
+	for p := range c.entries {
+		root, _, _ := strings.Cut(p, string(filepath.Separator))
+		if roots[root] && !keep[p] {
+			delete(c.entries, p)
+			dropped++
+		}
+	}
+	return dropped
+}
+
+// save writes the cache back to disk.
+func (c *hashCache) save() error {
+	c.mu.Lock()
+	data, err := json.Marshal(c.entries)
+	c.mu.Unlock()
+	if err != nil {
+		return fmt.Errorf("failed to marshal hash cache: %w", err)
+	}
+	return os.WriteFile(c.path, data, 0644)
+}
+
+// hashFile returns the content hash of a file: the first 128 bits of its SHA-256, in hex.
+func hashFile(path string) (string, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return "", err
+	}
+	defer f.Close()
+
+	h := sha256.New()
+	if _, err := io.Copy(h, f); err != nil {
+		return "", err
+	}
+	return hex.EncodeToString(h.Sum(nil)[:16]), nil
+}
+
+// hashStats summarizes a hashing run.
+type hashStats struct {
+	Files   int
+	Cached  int
+	Bytes   int64 // Bytes read for files not in the cache.
+	Mirrors int   // Entries marked as duplicates of an earlier entry.
+	Pruned  int   // Stale cache entries dropped.
+	Elapsed time.Duration
+}
+
+// String formats the stats for progress output.
+func (s hashStats) String() string {
+	return fmt.Sprintf("%d files (%d cached, %d MB read, %d stale dropped), %d mirrors in %s",
+		s.Files, s.Cached, s.Bytes>>20, s.Pruned, s.Mirrors, s.Elapsed.Round(time.Millisecond))
+}
+
+// hashEntries hashes all files of entries in parallel, reusing cached hashes, marks
+// every entry whose primary file duplicates the primary file of an earlier entry, and
+// drops cached hashes of files that are gone.
+func hashEntries(basePath string, entries []DBEntry, cache *hashCache) hashStats {
+	start := time.Now()
+
+	var relPaths []string
+	var files []*DBFile
+	for i := range entries {
+		for j := range entries[i].Files {
+			relPaths = append(relPaths, filepath.Join(entries[i].Path, entries[i].Files[j].Name))
+			files = append(files, &entries[i].Files[j])
+		}
+	}
+
+	var cached, bytes atomic.Int64
+	runParallel(len(files), func(i int) {
+		fullPath := filepath.Join(basePath, relPaths[i])
+		info, err := os.Stat(fullPath)
+		if err != nil {
+			return
+		}
+		if hash, ok := cache.lookup(relPaths[i], info); ok {
+			files[i].Hash = hash
+			cached.Add(1)
+			return
+		}
+		hash, err := hashFile(fullPath)
+		if err != nil {
+			return
+		}
+		files[i].Hash = hash
+		cache.store(relPaths[i], info, hash)
+		bytes.Add(info.Size())
+	})
+
+	stats := hashStats{Files: len(files), Cached: int(cached.Load()), Bytes: bytes.Load()}
+	stats.Pruned = cache.prune(relPaths)
+	stats.Mirrors = markMirrors(entries)
+	stats.Elapsed = time.Since(start)
+	return stats
+}
+
+// markMirrors sets DuplicateOf on entries whose primary file hash was seen on an earlier
+// entry, and returns the number of entries marked.
+func markMirrors(entries []DBEntry) int {
+	first := make(map[string]int, len(entries))
+	mirrors := 0
+	for i := range entries {
+		entries[i].DuplicateOf = nil
+		hash := entries[i].primaryHash()
+		if hash == "" {
+			continue
+		}
+		if id, ok := first[hash]; ok {
+			entries[i].DuplicateOf = &id
+			mirrors++
+			continue
+		}
+		first[hash] = entries[i].ID
+	}
+	return mirrors
+}
+
+// primaryHash returns the content hash of the entry's primary file, or "" if unknown.
+func (e *DBEntry) primaryHash() string {
+	for i := range e.Files {
+		if e.Files[i].Name == e.PrimaryFile {
+			return e.Files[i].Hash
+		}
+	}
+	return ""
+}
+
+// indexContentHashes hashes the files of entries using the persistent hash cache of
+// basePath, marks mirrors and prints progress.
+func indexContentHashes(basePath string, entries []DBEntry) {
+	fmt.Println("Hashing files...")
+	cache := loadHashCache(basePath)
+	fmt.Printf("  Hashes: %s\n", hashEntries(basePath, entries, cache))
+	if err := cache.save(); err != nil {
+		fmt.Printf("  Warning: failed to save hash cache: %v\n", err)
+	}
+}
+
+// canonical returns the index of the first entry whose primary file has the same content
+// as entry id, or id itself if it has no earlier mirror or no hash.
+func (index *SearchIndex) canonical(id int) int {
+	index.canonicalOnce.Do(func() {
+		first := make(map[string]int)
+		index.canonicalIdx = make([]int, len(index.Entries))
+		for i := range index.Entries {
+			index.canonicalIdx[i] = i
+			hash := index.Entries[i].Hash
+			if hash == "" {
+				continue
+			}
+			if j, ok := first[hash]; ok {
+				index.canonicalIdx[i] = j
+			} else {
+				first[hash] = i
+			}
+		}
+	})
+	return index.canonicalIdx[id]
+}
+
+// collapseMirrors drops every entry of ids whose content already appeared earlier in ids,
+// keeping the order of the rest.
+func (index *SearchIndex) collapseMirrors(ids []int) []int {
+	seen := make(map[int]bool, len(ids))
+	out := ids[:0:0]
+	for _, id := range ids {
+		c := index.canonical(id)
+		if seen[c] {
+			continue
+		}
+		seen[c] = true
+		out = append(out, id)
+	}
+	return out
+}
@@ -0,0 +1,164 @@
+// Layout-aware directory traversal for the database generator.
+// Each collection has a fixed folder layout, so the walker only descends as deep as needed
+// and reads every directory exactly once, handing the listing to the caller for file collection.
+package main
+
+import (
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"time"
+)
+
+// scanLayout describes at which depths a collection keeps its release folders.
+// Depth is counted from the collection root: 1 = Letter, 2 = Letter/Title, etc.
+type scanLayout struct {
+	minDepth int // Shallowest depth at which directories are emitted.
+	maxDepth int // Deepest depth that is visited; nothing below is read.
+}
+
+// Known collection layouts.
+var (
+	layoutGamesCSDB    = scanLayout{minDepth: 5, maxDepth: 5} // Letter/Range/Title/Group/ReleaseName
+	layoutDemosCSDB    = scanLayout{minDepth: 3, maxDepth: 3} // Letter/Group/Title
+	layoutMusicCSDB    = scanLayout{minDepth: 2, maxDepth: 2} // Letter/Title
+	layoutMusicHVSC    = scanLayout{minDepth: 3, maxDepth: 3} // Letter/Author/Title
+	layoutSidCollected = scanLayout{minDepth: 2, maxDepth: 3} // Letter/Title or Letter/Author/Title
+)
+
+// scanStats counts filesystem calls made while scanning.
+type scanStats struct {
+	ReadDirs    int           // Number of os.ReadDir calls.
+	Stats       int           // Number of DirEntry.Info (lstat) calls.
+	ReadDirTime time.Duration // Time spent in os.ReadDir.
+	StatTime    time.Duration // Time spent in DirEntry.Info.
+	Elapsed     time.Duration // Wall clock time of the whole scan.
+}
+
+// String formats the syscall and time breakdown for progress output.
+func (s scanStats) String() string {
+	return fmt.Sprintf("%d readdir (%s), %d lstat (%s), %d syscalls in %s",
+		s.ReadDirs, s.ReadDirTime.Round(time.Millisecond),
+		s.Stats, s.StatTime.Round(time.Millisecond),
+		s.ReadDirs+s.Stats, s.Elapsed.Round(time.Millisecond))
+}
+
+// readDir reads a directory and records the call in stats.
+func (s *scanStats) readDir(path string) ([]os.DirEntry, error) {
+	start := time.Now()
+	entries, err := os.ReadDir(path)
+	s.ReadDirTime += time.Since(start)
+	s.ReadDirs++
+	return entries, err
+}
+
+// info stats a directory entry and records the call in stats.
+func (s *scanStats) info(entry os.DirEntry) (os.FileInfo, error) {
+	start := time.Now()
+	info, err := entry.Info()
+	s.StatTime += time.Since(start)
+	s.Stats++
+	return info, err
+}
+
+// walkLayout walks root down to layout.maxDepth and calls fn for every directory between
+// layout.minDepth and layout.maxDepth with its path components relative to root and its listing.
+// Directories are visited in lexical order, parents before children, matching filepath.WalkDir.
+func walkLayout(root string, layout scanLayout, stats *scanStats, fn func(parts []string, path string, entries []os.DirEntry)) error {
+	start := time.Now()
+	defer func() { stats.Elapsed += time.Since(start) }()
+
+	entries, err := stats.readDir(root)
+	if os.IsNotExist(err) {
+		// Missing collections are skipped, as filepath.WalkDir callers did.
+		return nil
+	}
+	if err != nil {
+		return err
+	}
+	walkLayoutDir(root, nil, entries, layout, stats, fn)
+	return nil
+}
+
+// walkLayoutDir descends into the subdirectories of an already read directory.
+func walkLayoutDir(path string, parts []string, entries []os.DirEntry, layout scanLayout, stats *scanStats, fn func(parts []string, path string, entries []os.DirEntry)) {
+	depth := len(parts) + 1
+	for _, entry := range entries {
+		if !entry.IsDir() {
+			continue
+		}
+
+		childPath := filepath.Join(path, entry.Name())
+		childParts := append(parts[:len(parts):len(parts)], entry.Name())
+
+		childEntries, err := stats.readDir(childPath)
+		if err != nil {
+			continue
+		}
+
+		if depth >= layout.minDepth {
+			fn(childParts, childPath, childEntries)
+		}
+		if depth < layout.maxDepth {
+			walkLayoutDir(childPath, childParts, childEntries, layout, stats, fn)
+		}
+	}
+}
+
+// collectReleaseFiles selects the supported files of a release folder from its listing.
+// It returns the files, the primary file name and its type.
+func collectReleaseFiles(entries []os.DirEntry, stats *scanStats) ([]DBFile, string, string) {
+	var files []DBFile
+	var primaryFile string
+	var fileType string
+
+	// Collect all supported files.
+	for _, entry := range entries {
+		if entry.IsDir() {
+			continue
+		}
+
+		ext := filepath.Ext(entry.Name())
+		if !supportedExtensions[ext] {
+			continue
+		}
+
+		info, err := stats.info(entry)
+		if err != nil {
+			continue
+		}
+
+		files = append(files, DBFile{
+			Name: entry.Name(),
+			Type: strings.ToLower(strings.TrimPrefix(ext, ".")),
+			Size: info.Size(),
+		})
+	}
+
+	if len(files) == 0 {
+		return nil, "", ""
+	}
+
+	// Select primary file by priority.
+	for _, ext := range fileTypePriority {
+		for _, f := range files {
+			if strings.EqualFold("."+f.Type, ext) {
+				primaryFile = f.Name
+				fileType = f.Type
+				break
+			}
+		}
+		if primaryFile != "" {
+			break
+		}
+	}
+
+	// Fallback to first file.
+	if primaryFile == "" && len(files) > 0 {
+		primaryFile = files[0].Name
+		fileType = files[0].Type
+	}
+
+	return files, primaryFile, fileType
+}
@@ -0,0 +1,247 @@
+// Cross-reference metadata stage for the database generator.
+// The Top200, Year, Party, Onefile and Rating trees are scanned concurrently over a shared,
+// memoized directory listing cache and merged into one metadata table per category.
+package main
+
+import (
+	"fmt"
+	"os"
+	"runtime"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// dirCache memoizes os.ReadDir results so that every directory is read at most once,
+// even when several concurrent scanners visit overlapping trees.
+type dirCache struct {
+	mu      sync.Mutex
+	entries map[string]*dirCacheEntry
+	stats   scanStats
+	created time.Time
+}
+
+// dirCacheEntry holds the listing of one directory, filled exactly once.
+type dirCacheEntry struct {
+	once    sync.Once
+	listing []os.DirEntry
+	err     error
+}
+
+// newDirCache creates an empty directory listing cache.
+func newDirCache() *dirCache {
+	return &dirCache{entries: make(map[string]*dirCacheEntry), created: time.Now()}
+}
+
+// readDir returns the cached listing of path, reading it on first use.
+func (c *dirCache) readDir(path string) ([]os.DirEntry, error) {
+	c.mu.Lock()
+	e, ok := c.entries[path]
+	if !ok {
+		e = &dirCacheEntry{}
+		c.entries[path] = e
+	}
+	c.mu.Unlock()
+
+	e.once.Do(func() {
+		start := time.Now()
+		e.listing, e.err = os.ReadDir(path)
+		elapsed := time.Since(start)
+
+		c.mu.Lock()
+		c.stats.ReadDirs++
+		c.stats.ReadDirTime += elapsed
+		c.mu.Unlock()
+	})
+	return e.listing, e.err
+}
+
+// Stats returns a snapshot of the filesystem calls made through the cache
+// and the time elapsed since it was created.
+func (c *dirCache) Stats() scanStats {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	stats := c.stats
+	stats.Elapsed = time.Since(c.created)
+	return stats
+}
+
+// runConcurrently runs all functions in parallel and waits for them to finish.
+func runConcurrently(fns ...func()) {
+	var wg sync.WaitGroup
+	for _, fn := range fns {
+		wg.Add(1)
+		go func(fn func()) {
+			defer wg.Done()
+			fn()
+		}(fn)
+	}
+	wg.Wait()
+}
+
+// runParallel calls fn for 0..n-1 on one worker per CPU and waits for all calls to finish.
+func runParallel(n int, fn func(i int)) {
+	runParallelN(runtime.NumCPU(), n, fn)
+}
+
+// runParallelN calls fn for 0..n-1 on the given number of workers and waits for all
+// calls to finish. Latency-bound work such as stat calls benefits from more workers than CPUs.
+func runParallelN(workers, n int, fn func(i int)) {
+	var next atomic.Int64
+	var wg sync.WaitGroup
+	for w := 0; w < min(workers, n); w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := int(next.Add(1)) - 1; i < n; i = int(next.Add(1)) - 1 {
+				fn(i)
+			}
+		}()
+	}
+	wg.Wait()
+}
+
+// addRankedDirs adds "NN. Title" subdirectories of dirPath to rankMap as lowercased title -> rank.
+func addRankedDirs(rankMap map[string]int, dirPath string, cache *dirCache) {
+	entries, err := cache.readDir(dirPath)
+	if err != nil {
+		return
+	}
+
+	for _, entry := range entries {
+		if !entry.IsDir() {
+			continue
+		}
+
+		if match := rankPattern.FindStringSubmatch(entry.Name()); len(match) >= 3 {
+			rank, _ := strconv.Atoi(match[1])
+			title := strings.TrimSpace(match[2])
+			rankMap[strings.ToLower(title)] = rank
+		}
+	}
+}
+
+// demoMeta is the merged cross-reference metadata for one demoKey.
+// Records keyed by demoKey("", title) carry the sources that only know the title
+// (Top200, Top500, Year-top20 and the rated top lists).
+type demoMeta struct {
+	Top200Rank int
+	Top500Rank int
+	Year       int
+	HasYear    bool
+	YearRank   int // Rank within the year's top 20.
+	Party      *DemoPartyInfo
+	IsOnefile  bool
+	Rating     float64
+	RatingYear int
+	HasRating  bool
+}
+
+// buildDemosMetadata scans all demo cross-reference trees concurrently and merges them
+// into a single table keyed by demoKey.
+func buildDemosMetadata(basePath string, cache *dirCache) map[string]demoMeta {
+	var (
+		top200Map  map[string]int
+		top500Map  map[string]int
+		yearMap    map[string]DemoYearInfo
+		partyMap   map[string]DemoPartyInfo
+		onefileMap map[string]bool
+		ratingMap  map[string]DemoRatingInfo
+	)
+
+	runConcurrently(
+		func() { top200Map = buildDemosTop200Map(basePath, cache) },
+		func() { top500Map = buildDemosTop500Map(basePath, cache) },
+		func() { yearMap = buildDemosYearMap(basePath, cache) },
+		func() { partyMap = buildDemosPartyMap(basePath, cache) },
+		func() { onefileMap = buildDemosOnefileMap(basePath, cache) },
+		func() { ratingMap = buildDemosRatingMap(basePath, cache) },
+	)
+
+	fmt.Printf("  Top200... %d entries\n", len(top200Map))
+	fmt.Printf("  Top500... %d entries\n", len(top500Map))
+	fmt.Printf("  Year data... %d entries\n", len(yearMap))
+	fmt.Printf("  Party data... %d entries\n", len(partyMap))
+	fmt.Printf("  Onefile... %d entries\n", len(onefileMap))
+	fmt.Printf("  Ratings... %d entries\n", len(ratingMap))
+
+	// Merge in a fixed order so the result does not depend on scheduling.
+	table := make(map[string]demoMeta, len(yearMap)+len(ratingMap))
+	for title, rank := range top200Map {
+		m := table[demoKey("", title)]
+		m.Top200Rank = rank
+		table[demoKey("", title)] = m
+	}
+	for title, rank := range top500Map {
+		m := table[demoKey("", title)]
+		m.Top500Rank = rank
+		table[demoKey("", title)] = m
+	}
+	for key, info := range yearMap {
+		m := table[key]
+		m.Year = info.Year
+		m.HasYear = true
+		m.YearRank = info.YearRank
+		table[key] = m
+	}
+	for key, info := range partyMap {
+		info := info
+		m := table[key]
+		m.Party = &info
+		table[key] = m
+	}
+	for key := range onefileMap {
+		m := table[key]
+		m.IsOnefile = true
+		table[key] = m
+	}
+	for key, info := range ratingMap {
+		m := table[key]
+		m.Rating = info.Rating
+		m.RatingYear = info.Year
+		m.HasRating = true
+		table[key] = m
+	}
+
+	return table
+}
+
+// musicMeta is the merged cross-reference metadata for one lowercased music title.
+type musicMeta struct {
+	Top200Rank int
+	Party      *MusicPartyInfo
+}
+
+// buildMusicMetadata scans the music cross-reference trees concurrently and merges them
+// into a single table keyed by lowercased title.
+func buildMusicMetadata(basePath string, cache *dirCache) map[string]musicMeta {
+	var (
+		top200Map map[string]int
+		partyMap  map[string]MusicPartyInfo
+	)
+
+	runConcurrently(
+		func() { top200Map = buildMusicTop200Map(basePath, cache) },
+		func() { partyMap = buildMusicPartyMap(basePath, cache) },
+	)
+
+	fmt.Printf("  Top200... %d entries\n", len(top200Map))
+	fmt.Printf("  Party data... %d entries\n", len(partyMap))
+
+	table := make(map[string]musicMeta, len(top200Map)+len(partyMap))
+	for title, rank := range top200Map {
+		m := table[title]
+		m.Top200Rank = rank
+		table[title] = m
+	}
+	for title, info := range partyMap {
+		info := info
+		m := table[title]
+		m.Party = &info
+		table[title] = m
+	}
+
+	return table
+}
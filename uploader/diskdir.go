@@ -0,0 +1,141 @@
+// Directory listings of disk image entries.
+// Parsed directories are cached per entry, so browsing a disk's files before choosing
+// one to run reads and parses the image only once.
+package main
+
+import (
+	"fmt"
+	"os"
+	"strings"
+	"sync"
+)
+
+// diskDirCacheMaxEntries bounds the number of cached directories; the cache is dropped when full.
+const diskDirCacheMaxEntries = 256
+
+// diskDirectory is the parsed directory of a disk image.
+type diskDirectory struct {
+	name       string // Disk name from the header.
+	id         string // Disk ID from the header.
+	format     string
+	blocksFree int
+	files      []directoryEntry
+}
+
+// diskDirCache holds parsed directories by canonical entry index.
+type diskDirCache struct {
+	mu   sync.Mutex
+	dirs map[int]*diskDirectory
+}
+
+// isDiskImageType reports whether a file type is a disk image with a directory.
+func isDiskImageType(fileType string) bool {
+	switch strings.ToLower(fileType) {
+	case "d64", "d71", "d81", "g64", "g71":
+		return true
+	}
+	return false
+}
+
+// diskDirectory returns the parsed directory of entry id, reading the image on a cache miss.
+func (index *SearchIndex) diskDirectory(id int) (*diskDirectory, error) {
+	if id < 0 || id >= len(index.Entries) {
+		return nil, fmt.Errorf("invalid ID: %d", id)
+	}
+	entry := &index.Entries[id]
+	if !isDiskImageType(entry.FileType) {
+		return nil, fmt.Errorf("%s is not a disk image", entry.Name)
+	}
+
+	// Use the directory indexed by dbgen if there is one.
+	if d := entry.Disk; d != nil {
+		if len(d.Files) == 0 {
+			return nil, fmt.Errorf("broken disk image: %s", d.Error)
+		}
+		dir := &diskDirectory{name: d.Name, id: d.ID, format: d.Format, blocksFree: d.BlocksFree}
+		for i := range d.Files {
+			dir.files = append(dir.files, d.Files[i].directoryEntry())
+		}
+		return dir, nil
+	}
+
+	// Mirrors share one cached directory.
+	key := index.canonical(id)
+	c := &index.dirs
+	c.mu.Lock()
+	dir, ok := c.dirs[key]
+	c.mu.Unlock()
+	if ok {
+		return dir, nil
+	}
+
+	// Parse outside the lock; concurrent misses for one entry parse it twice.
+	data, err := os.ReadFile(index.fullPath(entry))
+	if err != nil {
+		return nil, fmt.Errorf("reading disk image: %w", err)
+	}
+	img, err := openDiskImage(data, entry.FileType)
+	if err != nil {
+		return nil, err
+	}
+	files, err := img.directory()
+	if err != nil {
+		return nil, err
+	}
+	dir = &diskDirectory{format: img.format.name, blocksFree: img.blocksFree(), files: files}
+	dir.name, dir.id = img.header()
+
+	c.mu.Lock()
+	if c.dirs == nil || len(c.dirs) >= diskDirCacheMaxEntries {
+		c.dirs = make(map[int]*diskDirectory)
+	}
+	c.dirs[key] = dir
+	c.mu.Unlock()
+	return dir, nil
+}
+
+// diskError returns why PRG number file of a disk image entry (firstPRGFile for the
+// first one) cannot be run, as flagged by dbgen, or nil if it was not flagged.
+func (e *ReleaseEntry) diskError(file int) error {
+	if e.Disk == nil {
+		return nil
+	}
+	if reason := e.Disk.fileError(file); reason != "" {
+		return fmt.Errorf("broken disk image: %s", reason)
+	}
+	return nil
+}
+
+// prgLocation locates PRG number file of a disk image entry, or its first PRG if file
+// is firstPRGFile. The first sector is taken from the indexed directory when possible,
+// so the image's directory need not be parsed at launch.
+func (e *ReleaseEntry) prgLocation(file int) prgLocation {
+	loc := prgLocation{file: file}
+	d := e.Disk
+	if d == nil || d.Error != "" {
+		return loc
+	}
+	if file == firstPRGFile {
+		file = *d.FirstPRG
+	}
+	if file < 0 || file >= len(d.Files) || d.Files[file].Type&0x0F != fileTypePRG {
+		// Let the directory parser report the error.
+		return loc
+	}
+	f := d.Files[file]
+	loc.track, loc.sector, loc.name = f.Track, f.Sector, f.Name
+	return loc
+}
+
+// listingType returns the type column of a directory listing, e.g. "PRG", "*SEQ" for
+// an unclosed file or "PRG<" for a locked one.
+func (e *directoryEntry) listingType() string {
+	t := e.typeName()
+	if !e.closed {
+		t = "*" + t
+	}
+	if e.locked {
+		t += "<"
+	}
+	return t
+}
@@ -0,0 +1,218 @@
+// Facet counts for the advanced search UIs.
+// The posting lists of every facet value are kept as bitsets, so the number of entries
+// matching each option under the current filters costs one popcount pass per value.
+package main
+
+import (
+	"math/bits"
+	"sort"
+	"strings"
+)
+
+// facetField is a field that the advanced search filters by exact value.
+type facetField int
+
+const (
+	facetFileType facetField = iota
+	facetLanguage
+	facetRegion
+	facetEngine
+	facetTop200
+	facetSIDChips
+	facetFieldCount // Sentinel for field count.
+)
+
+// facetFieldNames are the protocol keys of the facet fields, as used by ADVSEARCH.
+var facetFieldNames = [facetFieldCount]string{"type", "lang", "region", "engine", "top200", "sids"}
+
+// bitset is a set of entry indices.
+type bitset []uint64
+
+// bitsetOf returns a bitset of n entries holding the given indices.
+func bitsetOf(indices []int, n int) bitset {
+	b := make(bitset, (n+63)/64)
+	for _, i := range indices {
+		b[i/64] |= 1 << (i % 64)
+	}
+	return b
+}
+
+// and returns the intersection of b and o.
+func (b bitset) and(o bitset) bitset {
+	r := make(bitset, len(b))
+	for i := range b {
+		r[i] = b[i] & o[i]
+	}
+	return r
+}
+
+// andCount returns the size of the intersection of b and o.
+func (b bitset) andCount(o bitset) int {
+	n := 0
+	for i := range b {
+		n += bits.OnesCount64(b[i] & o[i])
+	}
+	return n
+}
+
+// count returns the number of entries in b.
+func (b bitset) count() int {
+	n := 0
+	for _, w := range b {
+		n += bits.OnesCount64(w)
+	}
+	return n
+}
+
+// facetBitsets holds a bitset per facet value and per category.
+type facetBitsets struct {
+	all        bitset
+	categories map[string]bitset                  // Lowercased category -> entries.
+	values     [facetFieldCount]map[string]bitset // Lowercased value -> entries.
+}
+
+// facetBits returns the facet bitsets, building them on first use.
+func (index *SearchIndex) facetBits() *facetBitsets {
+	index.facetBitsOnce.Do(func() {
+		f := index.facets()
+		n := len(index.Entries)
+
+		fb := &facetBitsets{categories: make(map[string]bitset)}
+		all := make([]int, n)
+		for i := range all {
+			all[i] = i
+		}
+		fb.all = bitsetOf(all, n)
+		for cat, postings := range f.byCategory {
+			fb.categories[cat] = bitsetOf(postings, n)
+		}
+
+		fields := [facetFieldCount]map[string][]int{
+			facetFileType: f.byFileType,
+			facetLanguage: f.byLanguage,
+			facetRegion:   f.byRegion,
+			facetEngine:   f.byEngine,
+			facetTop200:   {"1": f.top200},
+			facetSIDChips: f.bySIDChips,
+		}
+		for field, m := range fields {
+			fb.values[field] = make(map[string]bitset, len(m))
+			for value, postings := range m {
+				fb.values[field][value] = bitsetOf(postings, n)
+			}
+		}
+
+		index.facetBitsIdx = fb
+	})
+	return index.facetBitsIdx
+}
+
+// facetValueCount is the number of matches for one facet value.
+type facetValueCount struct {
+	Value string
+	Count int
+}
+
+// facetCounts are the per-value match counts of all facet fields for one filter set.
+type facetCounts struct {
+	Total  int // Entries matching all filters.
+	Fields [facetFieldCount][]facetValueCount
+}
+
+// facetSelection returns the lowercased value selected for field, or "" for any.
+func facetSelection(as AdvancedSearch, field facetField) string {
+	switch field {
+	case facetFileType:
+		return strings.ToLower(as.FileType)
+	case facetLanguage:
+		return strings.ToLower(as.Language)
+	case facetRegion:
+		return strings.ToLower(as.Region)
+	case facetEngine:
+		return strings.ToLower(as.Engine)
+	case facetTop200:
+		if as.Top200Only {
+			return "1"
+		}
+	case facetSIDChips:
+		return as.SIDChips
+	}
+	return ""
+}
+
+// countFacets counts, for every value of every facet field, the entries that would match
+// if that value were selected together with all other current filters. Values without
+// matches are omitted; each field is sorted by count, highest first.
+func countFacets(index *SearchIndex, as AdvancedSearch) *facetCounts {
+	fb := index.facetBits()
+
+	// Entries matching the non-facet filters. A category alone needs no scan.
+	base := as
+	base.FileType, base.Language, base.Region, base.Engine, base.Top200Only, base.SIDChips = "", "", "", "", false, ""
+	plan := compileSearch(index, base)
+	var baseBits bitset
+	switch {
+	case len(plan.preds) > 0:
+		baseBits = bitsetOf(plan.run(index), len(index.Entries))
+	case plan.candidates != nil:
+		baseBits = fb.categories[strings.ToLower(as.Category)]
+		if baseBits == nil {
+			baseBits = bitsetOf(nil, len(index.Entries))
+		}
+	default:
+		baseBits = fb.all
+	}
+
+	// Bitsets of the selected values; unknown values select nothing.
+	var selected [facetFieldCount]bitset
+	for field := facetField(0); field < facetFieldCount; field++ {
+		if value := facetSelection(as, field); value != "" {
+			selected[field] = fb.values[field][value]
+			if selected[field] == nil {
+				selected[field] = bitsetOf(nil, len(index.Entries))
+			}
+		}
+	}
+
+	counts := &facetCounts{}
+	total := baseBits
+	for field := facetField(0); field < facetFieldCount; field++ {
+		// Each field is counted under all filters except its own.
+		mask := baseBits
+		for other := facetField(0); other < facetFieldCount; other++ {
+			if other != field && selected[other] != nil {
+				mask = mask.and(selected[other])
+			}
+		}
+		if selected[field] != nil {
+			total = total.and(selected[field])
+		}
+
+		for value, b := range fb.values[field] {
+			if n := mask.andCount(b); n > 0 {
+				counts.Fields[field] = append(counts.Fields[field], facetValueCount{value, n})
+			}
+		}
+		sort.Slice(counts.Fields[field], func(a, b int) bool {
+			ca, cb := counts.Fields[field][a], counts.Fields[field][b]
+			if ca.Count != cb.Count {
+				return ca.Count > cb.Count
+			}
+			return ca.Value < cb.Value
+		})
+	}
+	counts.Total = total.count()
+
+	return counts
+}
+
+// count returns the number of matches for value of field, 0 if it has none.
+func (c *facetCounts) count(field facetField, value string) int {
+	value = strings.ToLower(value)
+	for _, vc := range c.Fields[field] {
+		if vc.Value == value {
+			return vc.Count
+		}
+	}
+	return 0
+}
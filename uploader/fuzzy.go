@@ -0,0 +1,272 @@
+// Ranked and typo-tolerant title search.
+// Typo matches are found through a trigram index over compacted titles and verified with
+// a bounded edit distance under a fixed time budget; results are ranked in match tiers.
+package main
+
+import (
+	"sort"
+	"strings"
+	"time"
+)
+
+const (
+	// fuzzyBudget bounds the time spent finding typo matches for one query.
+	fuzzyBudget = 10 * time.Millisecond
+
+	// fuzzyCheckInterval is how many candidates are verified between budget checks.
+	fuzzyCheckInterval = 256
+
+	// fuzzyMaxTypos is the largest edit distance accepted for long queries.
+	fuzzyMaxTypos = 2
+
+	// fuzzyCommonDivisor marks trigrams found in more than 1/fuzzyCommonDivisor of all
+	// titles as too common to count; they are assumed present instead.
+	fuzzyCommonDivisor = 8
+)
+
+// Match tiers, best first.
+const (
+	tierExact  = iota // Title equals the query.
+	tierPrefix        // Title starts with the query.
+	tierWord          // A word of the title starts with the query.
+	tierTitle         // Query occurs inside the title.
+	tierGroup         // Query occurs in the group or composer only.
+	tierTypo1         // Title matches with one typo.
+	tierTypo2         // Title matches with two typos.
+	tierCount
+)
+
+// trigramIndex maps trigrams of compacted titles to the entries containing them.
+type trigramIndex struct {
+	compact  []string           // Lowercased titles with only letters and digits.
+	postings map[uint32][]int32 // Trigram -> ascending entry indices.
+}
+
+// trigrams returns the trigram index, building it on first use.
+func (index *SearchIndex) trigrams() *trigramIndex {
+	index.trigramsOnce.Do(func() {
+		f := index.facets()
+		t := &trigramIndex{
+			compact:  make([]string, len(f.names)),
+			postings: make(map[uint32][]int32),
+		}
+		for i, name := range f.names {
+			t.compact[i] = compactTitle(name)
+			for _, key := range trigramKeys(t.compact[i]) {
+				t.postings[key] = append(t.postings[key], int32(i))
+			}
+		}
+		index.trigramIdx = t
+	})
+	return index.trigramIdx
+}
+
+// compactTitle lowercases s and drops everything except letters and digits,
+// so that "Turrican 2" and "turrican2" compare equal.
+func compactTitle(s string) string {
+	var b strings.Builder
+	b.Grow(len(s))
+	for _, r := range strings.ToLower(s) {
+		if (r >= 'a' && r <= 'z') || (r >= '0' && r <= '9') || r > 127 {
+			b.WriteRune(r)
+		}
+	}
+	return b.String()
+}
+
+// trigramKeys returns the distinct trigrams of s packed into integers.
+func trigramKeys(s string) []uint32 {
+	if len(s) < 3 {
+		return nil
+	}
+	keys := make([]uint32, 0, len(s)-2)
+	seen := make(map[uint32]bool, len(s)-2)
+	for i := 0; i+3 <= len(s); i++ {
+		key := uint32(s[i])<<16 | uint32(s[i+1])<<8 | uint32(s[i+2])
+		if !seen[key] {
+			seen[key] = true
+			keys = append(keys, key)
+		}
+	}
+	return keys
+}
+
+// allowedTypos returns the edit distance tolerated for a compacted query of length n.
+// Short queries must match exactly; every typo needs enough trigrams left to find candidates.
+func allowedTypos(n int) int {
+	return min((n-4)/3, fuzzyMaxTypos)
+}
+
+// findTypoMatches returns the entries whose compacted title contains the compacted query
+// within the allowed edit distance, with their distances. Candidates sharing too few
+// trigrams with the query are skipped, and the search stops when fuzzyBudget is used up.
+func findTypoMatches(index *SearchIndex, query string) ([]int, map[int]int) {
+	cq := compactTitle(query)
+	k := allowedTypos(len(cq))
+	if k <= 0 {
+		return nil, nil
+	}
+
+	// An insertion, deletion or substitution destroys at most three trigrams of the query,
+	// an adjacent transposition (also one edit) at most four.
+	keys := trigramKeys(cq)
+	threshold := len(keys) - 4*k
+	if threshold < 1 {
+		return nil, nil
+	}
+
+	t := index.trigrams()
+	deadline := time.Now().Add(fuzzyBudget)
+
+	// Count the rarest trigrams first so that the most selective candidates are verified
+	// first; common trigrams would touch most of the index and are skipped.
+	sort.Slice(keys, func(a, b int) bool {
+		return len(t.postings[keys[a]]) < len(t.postings[keys[b]])
+	})
+	for len(keys) > 0 && len(t.postings[keys[len(keys)-1]]) > len(t.compact)/fuzzyCommonDivisor {
+		keys = keys[:len(keys)-1]
+		threshold--
+	}
+	if threshold < 1 {
+		return nil, nil
+	}
+
+	counts := make([]uint8, len(t.compact))
+	var touched []int32
+	for _, key := range keys {
+		if time.Now().After(deadline) {
+			break
+		}
+		for _, i := range t.postings[key] {
+			if counts[i] == 0 {
+				touched = append(touched, i)
+			}
+			if counts[i] < 255 {
+				counts[i]++
+			}
+		}
+	}
+
+	var hits []int
+	dist := make(map[int]int)
+	for n, i := range touched {
+		if n%fuzzyCheckInterval == 0 && time.Now().After(deadline) {
+			break
+		}
+		if int(counts[i]) < threshold {
+			continue
+		}
+		if d := substringDistance(cq, t.compact[i], k); d >= 0 {
+			hits = append(hits, int(i))
+			dist[int(i)] = d
+		}
+	}
+
+	sort.Ints(hits)
+	return hits, dist
+}
+
+// substringDistance returns the smallest optimal string alignment distance between
+// pattern and any substring of text, or -1 if it exceeds k. Unlike plain Levenshtein
+// distance, swapping two adjacent characters ("misison") counts as a single edit.
+func substringDistance(pattern, text string, k int) int {
+	m := len(pattern)
+	// Distance columns after the current, previous and second previous text position.
+	cur := make([]int, m+1)
+	prev := make([]int, m+1)
+	prev2 := make([]int, m+1)
+	for j := range prev {
+		prev[j] = j
+	}
+
+	best := prev[m]
+	for t := 0; t < len(text) && best > 0; t++ {
+		// A match may start at any position in the text.
+		cur[0] = 0
+		for j := 1; j <= m; j++ {
+			cost := 1
+			if pattern[j-1] == text[t] {
+				cost = 0
+			}
+			d := min(min(prev[j], cur[j-1])+1, prev[j-1]+cost)
+			if j > 1 && t > 0 && pattern[j-1] == text[t-1] && pattern[j-2] == text[t] {
+				d = min(d, prev2[j-2]+1)
+			}
+			cur[j] = d
+		}
+		best = min(best, cur[m])
+		prev2, prev, cur = prev, cur, prev2
+	}
+
+	if best > k {
+		return -1
+	}
+	return best
+}
+
+// matchTier classifies how entry i matches the lowercased query.
+func (p *queryPlan) matchTier(f *facetIndex, i int) int {
+	name := f.names[i]
+	switch {
+	case name == p.query:
+		return tierExact
+	case strings.HasPrefix(name, p.query):
+		return tierPrefix
+	}
+
+	if pos := strings.Index(name, p.query); pos >= 0 {
+		for ; pos >= 0; pos = indexFrom(name, p.query, pos+1) {
+			if !isWordChar(name[pos-1]) {
+				return tierWord
+			}
+		}
+		return tierTitle
+	}
+	if strings.Contains(f.groups[i], p.query) || strings.Contains(f.authors[i], p.query) {
+		return tierGroup
+	}
+
+	if d, ok := p.typoDist[i]; ok && d == 0 {
+		return tierTitle
+	} else if ok && d == 1 {
+		return tierTypo1
+	}
+	return tierTypo2
+}
+
+// indexFrom returns the index of substr in s at or after start, or -1.
+func indexFrom(s, substr string, start int) int {
+	if start > len(s) {
+		return -1
+	}
+	if pos := strings.Index(s[start:], substr); pos >= 0 {
+		return start + pos
+	}
+	return -1
+}
+
+// isWordChar reports whether c is part of a word.
+func isWordChar(c byte) bool {
+	return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c > 127
+}
+
+// rank orders results by match tier; within a tier, Top200 entries come first,
+// then higher rated ones. Plans without a text query leave the order unchanged.
+func (p *queryPlan) rank(index *SearchIndex, results []int) []int {
+	if p.query == "" || len(results) < 2 {
+		return results
+	}
+
+	f := index.facets()
+	var tiers [tierCount][]int
+	for _, i := range results {
+		tier := p.matchTier(f, i)
+		tiers[tier] = append(tiers[tier], i)
+	}
+
+	ranked := make([]int, 0, len(results))
+	for _, tier := range tiers {
+		ranked = append(ranked, index.sortResults(tier, sortPopular)...)
+	}
+	return ranked
+}
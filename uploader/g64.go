@@ -0,0 +1,194 @@
+// GCR decoding of G64 and G71 disk images.
+// Every track is scanned bit by bit for sync marks, sector headers and data blocks are
+// decoded from GCR, and the sectors are assembled into a D64 or D71 image.
+package main
+
+import (
+	"encoding/binary"
+	"fmt"
+	"log/slog"
+)
+
+// GCR image constants.
+const (
+	g64HeaderSize    = 12
+	g64MinSyncBits   = 10 // A sync mark is at least 10 one bits.
+	gcrHeaderBlockID = 0x08
+	gcrDataBlockID   = 0x07
+	gcrDataBlockSize = 260 // Block ID, 256 data bytes, checksum and two off bytes.
+	g71Side2Base     = 84  // Half-track index of track 36 (side 2, track 1) in G71 images.
+)
+
+// gcrDecodeTable maps 5-bit GCR codes to nybbles; invalid codes are -1.
+var gcrDecodeTable = func() [32]int8 {
+	var t [32]int8
+	for i := range t {
+		t[i] = -1
+	}
+	for nybble, code := range [16]byte{
+		0x0A, 0x0B, 0x12, 0x13, 0x0E, 0x0F, 0x16, 0x17,
+		0x09, 0x19, 0x1A, 0x1B, 0x0D, 0x1D, 0x1E, 0x15,
+	} {
+		t[code] = int8(nybble)
+	}
+	return t
+}()
+
+// gcrTrack is the raw bit stream of one track. Reads wrap around, as on a spinning disk.
+type gcrTrack []byte
+
+// bit returns the bit at position pos.
+func (t gcrTrack) bit(pos int) int {
+	pos %= len(t) * 8
+	return int(t[pos/8]>>(7-pos%8)) & 1
+}
+
+// decode decodes n bytes from the GCR stream starting at bit position pos.
+// It returns false if a code is not valid GCR.
+func (t gcrTrack) decode(pos, n int) ([]byte, bool) {
+	out := make([]byte, n)
+	for i := 0; i < n; i++ {
+		var hi, lo int
+		for b := 0; b < 5; b++ {
+			hi = hi<<1 | t.bit(pos+b)
+			lo = lo<<1 | t.bit(pos+5+b)
+		}
+		if gcrDecodeTable[hi] < 0 || gcrDecodeTable[lo] < 0 {
+			return nil, false
+		}
+		out[i] = byte(gcrDecodeTable[hi])<<4 | byte(gcrDecodeTable[lo])
+		pos += 10
+	}
+	return out, true
+}
+
+// decodeSectors decodes the sectors of a track into sectors, indexed by sector number.
+// Sectors that were not found or fail their checksum stay nil.
+func (t gcrTrack) decodeSectors(track int, sectors [][]byte) {
+	bits := len(t) * 8
+	header := -1 // Sector of the last header seen, until its data block follows.
+	ones := 0
+
+	// Scan one revolution, plus enough to see a sync mark that wraps around.
+	for pos := 0; pos < bits+g64MinSyncBits; pos++ {
+		if t.bit(pos) == 1 {
+			ones++
+			continue
+		}
+		if ones < g64MinSyncBits {
+			ones = 0
+			continue
+		}
+		ones = 0
+
+		id, ok := t.decode(pos, 1)
+		if !ok {
+			header = -1
+			continue
+		}
+		switch id[0] {
+		case gcrHeaderBlockID:
+			// ID, checksum, sector, track and the two disk ID bytes.
+			hdr, ok := t.decode(pos, 6)
+			header = -1
+			if ok && int(hdr[3]) == track && int(hdr[2]) < len(sectors) && hdr[1] == xorChecksum(hdr[2:6]) {
+				header = int(hdr[2])
+			}
+		case gcrDataBlockID:
+			if header >= 0 && sectors[header] == nil {
+				block, ok := t.decode(pos, gcrDataBlockSize)
+				if ok && block[257] == xorChecksum(block[1:257]) {
+					sectors[header] = block[1:257]
+				}
+			}
+			header = -1
+		}
+	}
+}
+
+// xorChecksum returns the XOR of all bytes.
+func xorChecksum(data []byte) byte {
+	var sum byte
+	for _, b := range data {
+		sum ^= b
+	}
+	return sum
+}
+
+// decodeGCRImage decodes a G64 or G71 image into a D64 or D71 image.
+func decodeGCRImage(data []byte) (*diskImage, error) {
+	if len(data) < g64HeaderSize {
+		return nil, fmt.Errorf("invalid GCR image: too short")
+	}
+
+	var format *diskFormat
+	switch string(data[:8]) {
+	case "GCR-1541":
+		format = formatD64Tracks40
+	case "GCR-1571":
+		format = formatD71
+	default:
+		return nil, fmt.Errorf("invalid GCR image signature: %q", data[:8])
+	}
+	halfTracks := int(data[9])
+	if len(data) < g64HeaderSize+halfTracks*4 {
+		return nil, fmt.Errorf("invalid GCR image: truncated track table")
+	}
+
+	// trackData returns the raw GCR data of a track, or nil if the image has none.
+	trackData := func(track int) gcrTrack {
+		halfTrack := 2 * (track - 1)
+		if format == formatD71 && track > d64Tracks35 {
+			halfTrack = g71Side2Base + 2*(track-d64Tracks35-1)
+		}
+		if halfTrack >= halfTracks {
+			return nil
+		}
+		offset := int(binary.LittleEndian.Uint32(data[g64HeaderSize+halfTrack*4:]))
+		if offset == 0 || offset+2 > len(data) {
+			return nil
+		}
+		size := int(binary.LittleEndian.Uint16(data[offset:]))
+		if size == 0 || offset+2+size > len(data) {
+			return nil
+		}
+		return gcrTrack(data[offset+2 : offset+2+size])
+	}
+
+	img := &diskImage{format: format, data: make([]byte, format.size)}
+	decoded, missing, extended := 0, 0, false
+	for track := 1; track <= len(format.sectors); track++ {
+		raw := trackData(track)
+		sectors := make([][]byte, format.sectors[track-1])
+		if raw != nil {
+			raw.decodeSectors(track, sectors)
+		}
+		for s, sector := range sectors {
+			if sector == nil {
+				missing++
+				continue
+			}
+			decoded++
+			if format == formatD64Tracks40 && track > d64Tracks35 {
+				extended = true
+			}
+			copy(img.data[format.sectorOffset(track, s):], sector)
+		}
+	}
+
+	if decoded == 0 {
+		return nil, fmt.Errorf("invalid GCR image: no readable sectors")
+	}
+
+	// Only keep the extra tracks of a 1541 image if they hold data.
+	if format == formatD64Tracks40 && !extended {
+		img.format = formatD64
+		img.data = img.data[:formatD64.size]
+		missing -= formatD64Tracks40.sectorCount() - formatD64.sectorCount()
+	}
+	if missing > 0 {
+		slog.Debug("GCR image has unreadable sectors", "format", img.format.name, "missing", missing)
+	}
+
+	return img, nil
+}
@@ -9,6 +9,7 @@ import (
 	"os"
 	"path/filepath"
 	"strings"
+	"sync"
 )
 
 // LoadIndexFromJSON loads a SearchIndex from our generated JSON database file.
@@ -16,30 +17,32 @@ import (
 func LoadIndexFromJSON(jsonPath, assembly64Path string) (*SearchIndex, error) {
 	slog.Info("Loading index from JSON database", "path", jsonPath)
 
-	data, err := os.ReadFile(jsonPath)
+	db, err := readDatabase(jsonPath)
 	if err != nil {
-		return nil, fmt.Errorf("failed to read JSON database: %w", err)
-	}
-
-	var db Database
-	if err := json.Unmarshal(data, &db); err != nil {
-		return nil, fmt.Errorf("failed to parse JSON database: %w", err)
+		return nil, err
 	}
 
 	index := &SearchIndex{
 		Entries:       make([]ReleaseEntry, 0, len(db.Entries)),
 		ByCategory:    make(map[string][]int),
 		CategoryOrder: []string{"All"},
+		basePath:      assembly64Path,
 	}
 
+	p := startPhase("index.convert")
 	loadEntriesFromDB(index, db.Entries, assembly64Path)
+	p.setEntries(len(db.Entries))
+	p.end()
 
 	// Build "All" category with all indices.
+	p = startPhase("index.categories")
 	allIndices := make([]int, len(index.Entries))
 	for i := range allIndices {
 		allIndices[i] = i
 	}
 	index.ByCategory["All"] = allIndices
+	index.paths.seal()
+	p.end()
 
 	slog.Info("Index loaded from JSON", "total_entries", len(index.Entries), "categories", len(index.CategoryOrder)-1)
 	return index, nil
@@ -52,6 +55,7 @@ func LoadIndexFromMultipleJSON(jsonPaths []string, assembly64Path string) (*Sear
 		Entries:       make([]ReleaseEntry, 0, 200000),
 		ByCategory:    make(map[string][]int),
 		CategoryOrder: []string{"All"},
+		basePath:      assembly64Path,
 	}
 
 	foundCategories := make(map[string]bool)
@@ -60,33 +64,54 @@ func LoadIndexFromMultipleJSON(jsonPaths []string, assembly64Path string) (*Sear
 	for _, jsonPath := range jsonPaths {
 		slog.Info("Loading index from JSON database", "path", jsonPath)
 
-		data, err := os.ReadFile(jsonPath)
+		db, err := readDatabase(jsonPath)
 		if err != nil {
-			slog.Warn("Failed to read JSON database, skipping", "path", jsonPath, "error", err)
-			continue
-		}
-
-		var db Database
-		if err := json.Unmarshal(data, &db); err != nil {
-			slog.Warn("Failed to parse JSON database, skipping", "path", jsonPath, "error", err)
+			slog.Warn("Skipping JSON database", "path", jsonPath, "error", err)
 			continue
 		}
 
+		p := startPhase("index.convert")
 		loadEntriesFromDB(index, db.Entries, assembly64Path)
+		p.setEntries(len(db.Entries))
+		p.end()
 		slog.Info("Loaded entries from database", "path", jsonPath, "entries", db.TotalEntries)
 	}
 
 	// Build "All" category with all indices.
+	p := startPhase("index.categories")
 	allIndices := make([]int, len(index.Entries))
 	for i := range allIndices {
 		allIndices[i] = i
 	}
 	index.ByCategory["All"] = allIndices
+	index.paths.seal()
+	p.end()
 
 	slog.Info("Index loaded from multiple JSON files", "total_entries", len(index.Entries), "categories", len(index.CategoryOrder)-1)
 	return index, nil
 }
 
+// readDatabase reads and parses a JSON database file, timing both as phases.
+func readDatabase(jsonPath string) (*Database, error) {
+	p := startPhase("index.read")
+	data, err := os.ReadFile(jsonPath)
+	if err != nil {
+		return nil, fmt.Errorf("failed to read JSON database: %w", err)
+	}
+	p.addBytes(int64(len(data)))
+	p.end()
+
+	p = startPhase("index.parse")
+	var db Database
+	if err := json.Unmarshal(data, &db); err != nil {
+		return nil, fmt.Errorf("failed to parse JSON database: %w", err)
+	}
+	p.addBytes(int64(len(data)))
+	p.setEntries(len(db.Entries))
+	p.end()
+	return &db, nil
+}
+
 // loadEntriesFromDB loads entries from a Database into a SearchIndex.
 func loadEntriesFromDB(index *SearchIndex, entries []DBEntry, assembly64Path string) {
 	foundCategories := make(map[string]bool)
@@ -101,11 +126,11 @@ func loadEntriesFromDB(index *SearchIndex, entries []DBEntry, assembly64Path str
 		releaseEntry := ReleaseEntry{
 			Name:         entry.Title,
 			Group:        entry.Group,
-			Path:         entry.Path,
 			CategoryName: capitalizeFirst(entry.Category),
 			FileType:     entry.FileType,
-			// Compute full path: assembly64Path + path + primaryFile
-			FullPath: filepath.Join(assembly64Path, entry.Path, entry.PrimaryFile),
+			// Paths are interned and resolved on demand, see fullPath.
+			dir:  index.paths.intern(entry.Path),
+			file: entry.PrimaryFile,
 			// Extended fields from JSON database (games).
 			ReleaseName: entry.ReleaseName,
 			Language:    entry.Language,
@@ -120,6 +145,10 @@ func loadEntriesFromDB(index *SearchIndex, entries []DBEntry, assembly64Path str
 			Competition: entry.Competition,
 			IsOnefile:   entry.IsOnefile,
 			Rating:      entry.Rating,
+			// Extended fields (music).
+			Author:     entry.Author,
+			Collection: entry.Collection,
+			SID:        entry.SID,
 		}
 		// Handle pointer fields.
 		if entry.Top200Rank != nil {
@@ -137,6 +166,13 @@ func loadEntriesFromDB(index *SearchIndex, entries []DBEntry, assembly64Path str
 		if entry.PartyRank != nil {
 			releaseEntry.PartyRank = *entry.PartyRank
 		}
+		for i := range entry.Files {
+			if entry.Files[i].Name == entry.PrimaryFile {
+				releaseEntry.Disk = entry.Files[i].Disk
+				releaseEntry.Hash = entry.Files[i].Hash
+				break
+			}
+		}
 
 		index.Entries = append(index.Entries, releaseEntry)
 
@@ -173,9 +209,13 @@ type ReleaseEntry struct {
 
 	// Computed fields.
 	CategoryName string // "Games", "Demos", "Music", etc.
-	FullPath     string // Absolute path to the file.
+	FullPath     string // Absolute path to the file (legacy mode), see SearchIndex.fullPath.
 	FileType     string // "d64", "prg", "crt" - from extension.
 
+	// Interned path (JSON database mode), see SearchIndex.fullPath.
+	dir  pathRef // Release directory.
+	file string  // Primary file name.
+
 	// Extended fields (populated from JSON database, empty in legacy mode).
 	ReleaseName string     // Full release name with crack info (games).
 	Language    string     // german, french, english, etc.
@@ -195,17 +235,28 @@ type ReleaseEntry struct {
 	Competition string  // Competition type, e.g., "C64 Demo" (demos).
 	IsOnefile   bool    // Single-file demo (demos).
 	Rating      float64 // CSDB rating (demos).
+
+	// Music-specific fields.
+	Author     string   // Composer, from the folder name or the SID header.
+	Collection string   // Source collection: csdb, hvsc, 2sid, 3sid.
+	SID        *SIDInfo // SID header of the primary file (nil if not indexed).
+
+	Disk *DiskInfo // Indexed disk image content (nil if not indexed).
+	Hash string    // Content hash of the primary file ("" if not indexed).
 }
 
 // AdvancedSearch holds criteria for advanced searching.
 type AdvancedSearch struct {
 	Category    string // Category filter: "" (all), "Games", "Demos".
+	Query       string // Search in title or group.
 	Title       string // Search in title.
 	Group       string // Search in group.
 	Language    string // Exact match: german, french, etc.
 	Region      string // Exact match: PAL, NTSC.
 	Engine      string // Exact match: seuck, etc.
 	FileType    string // Exact match: d64, prg, crt.
+	Author      string // Search in composer (music).
+	SIDChips    string // Exact match: number of SID chips, 1-3 (music).
 	MinTrainers int    // Minimum number of trainers.
 	MaxTrainers int    // Maximum number of trainers (-1 = no limit).
 	Top200Only  bool   // Only show Top200 entries.
@@ -220,73 +271,173 @@ type SearchIndex struct {
 	Entries       []ReleaseEntry
 	ByCategory    map[string][]int // "Games" -> [indices].
 	CategoryOrder []string         // Ordered list: ["All", "Games", "Demos", ...].
+
+	basePath string    // Collection directory that interned paths are relative to.
+	paths    pathTable // Interned entry directories, see fullPath.
+
+	facetsOnce sync.Once
+	facetIdx   *facetIndex // Built on first search, see facets().
+
+	sorts sortCache // Sort permutations, see sortedView().
+
+	trigramsOnce sync.Once
+	trigramIdx   *trigramIndex // Built on first typo-tolerant search, see trigrams().
+
+	facetBitsOnce sync.Once
+	facetBitsIdx  *facetBitsets // Built on first facet count, see facetBits().
+
+	dirs diskDirCache // Parsed disk directories, see diskDirectory().
+
+	browseOnce sync.Once
+	browseIdx  *browseIndex // Group and composer lists, see browse().
+
+	responses responseCache // Formatted CATS and INFO responses, see handleCats().
+
+	canonicalOnce sync.Once
+	canonicalIdx  []int // First entry with the same content, see canonical().
+}
+
+// warmCaches builds the lazily computed search structures in a background goroutine, so
+// the first search or sort after loading does not build them on the TUI's Update loop.
+// Lookups made before a structure is ready wait for or build it as before.
+func (index *SearchIndex) warmCaches() {
+	go func() {
+		index.facets()
+		index.warmSorts()
+		index.trigrams()
+	}()
 }
 
-// processIndexPaths loads entries from .releaselog.json files.
-func processIndexPaths(basePath string, indexPaths []struct {
+// legacyScanWorkers bounds the concurrent stat and directory reads of the legacy loader.
+// Resolving entries is latency-bound rather than CPU-bound, so it uses more workers than CPUs.
+const legacyScanWorkers = 32
+
+// legacySource is a .releaselog.json file or an unindexed directory of the legacy layout.
+type legacySource struct {
 	category string
-	path     string
-}, index *SearchIndex, foundCategories map[string]bool, categoryEntries map[string]int) {
-	for _, indexPath := range indexPaths {
-		fullPath := filepath.Join(basePath, indexPath.path)
+	path     string // Relative to the assembly64 directory.
+}
 
-		// Check if file exists.
-		if _, err := os.Stat(fullPath); os.IsNotExist(err) {
-			continue // Skip missing index files
+// loadReleaseLogs loads the .releaselog.json files of sources in parallel. The result
+// holds the valid entries of each source at the source's position; missing or unreadable
+// files yield no entries. Files unchanged since they were cached are taken from cache;
+// the entries of all other files are resolved by one shared worker pool. The logs loaded
+// are recorded in next.
+func loadReleaseLogs(basePath string, sources []legacySource, cache, next *legacyCache) [][]ReleaseEntry {
+	logs := make([][]ReleaseEntry, len(sources))
+	stamps := make([]*legacyCachedLog, len(sources))
+	fresh := make([]bool, len(sources))
+	runParallel(len(sources), func(i int) {
+		fullPath := filepath.Join(basePath, sources[i].path)
+		info, err := os.Stat(fullPath)
+		if err != nil {
+			return // Skip missing index files.
 		}
-
-		entries, err := loadReleaseLog(fullPath, indexPath.category)
+		if cached := cache.Logs[sources[i].path]; cached.matches(info) {
+			logs[i] = releaseEntries(cached.Entries, sources[i].category)
+			stamps[i] = cached
+			return
+		}
+		entries, err := readReleaseLog(fullPath, sources[i].category)
 		if err != nil {
-			slog.Debug("Failed to load index", "path", indexPath.path, "error", err)
-			continue
+			slog.Debug("Failed to load index", "path", sources[i].path, "error", err)
+			return
 		}
+		logs[i] = entries
+		stamps[i] = &legacyCachedLog{ModTime: info.ModTime().UnixNano(), Size: info.Size()}
+		fresh[i] = true
+	})
 
-		// Add entries to index.
-		startIdx := len(index.Entries)
-		index.Entries = append(index.Entries, entries...)
-		categoryEntries[indexPath.category] += len(entries)
+	// Resolve the entries of all read files in one pool, so one large file does not serialize.
+	var pending []*ReleaseEntry
+	for i := range logs {
+		if fresh[i] {
+			for j := range logs[i] {
+				pending = append(pending, &logs[i][j])
+			}
+		}
+	}
+	valid := make([]bool, len(pending))
+	runParallelN(legacyScanWorkers, len(pending), func(k int) {
+		valid[k] = resolveReleaseEntry(pending[k])
+	})
 
-		// Track category.
-		if !foundCategories[indexPath.category] {
-			foundCategories[indexPath.category] = true
-			index.CategoryOrder = append(index.CategoryOrder, indexPath.category)
+	// Drop unresolved entries, keeping file order.
+	k := 0
+	for i := range logs {
+		if !fresh[i] {
+			continue
+		}
+		kept := logs[i][:0]
+		for j := range logs[i] {
+			if valid[k] {
+				kept = append(kept, logs[i][j])
+			}
+			k++
 		}
+		logs[i] = kept
+		stamps[i].Entries = cacheEntries(kept)
+	}
 
-		// Update ByCategory map.
-		for i := startIdx; i < len(index.Entries); i++ {
-			index.ByCategory[indexPath.category] = append(index.ByCategory[indexPath.category], i)
+	next.Logs = make(map[string]*legacyCachedLog, len(sources))
+	for i, stamp := range stamps {
+		if stamp != nil {
+			next.Logs[sources[i].path] = stamp
 		}
 	}
+	return logs
 }
 
-// processNoIndexDirs scans directories without .releaselog.json files.
-func processNoIndexDirs(basePath string, noIndexDirs []struct {
-	category string
-	path     string
-}, index *SearchIndex, foundCategories map[string]bool, categoryEntries map[string]int) {
-	for _, dir := range noIndexDirs {
-		dirPath := filepath.Join(basePath, dir.path)
+// scanNoIndexDirs scans the directories of sources in parallel for loadable files. The
+// result holds the entries of each directory at the source's position. Trees without
+// changed directories since they were cached are taken from cache. The scans are
+// recorded in next.
+func scanNoIndexDirs(basePath string, sources []legacySource, cache, next *legacyCache) [][]ReleaseEntry {
+	scans := make([][]ReleaseEntry, len(sources))
+	stamps := make([]*legacyCachedScan, len(sources))
+	runParallelN(len(sources), len(sources), func(i int) {
+		if cached := cache.Scans[sources[i].path]; cached.valid() {
+			scans[i] = releaseEntries(cached.Entries, sources[i].category)
+			stamps[i] = cached
+			return
+		}
+		dirPath := filepath.Join(basePath, sources[i].path)
 		if _, err := os.Stat(dirPath); os.IsNotExist(err) {
-			continue
+			return
 		}
+		entries, dirs := scanSingleDirectory(dirPath, sources[i].category)
+		scans[i] = entries
+		stamps[i] = &legacyCachedScan{Dirs: dirs, Entries: cacheEntries(entries)}
+	})
 
-		entries := scanSingleDirectory(dirPath, dir.category)
-		if len(entries) == 0 {
-			continue
+	next.Scans = make(map[string]*legacyCachedScan, len(sources))
+	for i, stamp := range stamps {
+		if stamp != nil {
+			next.Scans[sources[i].path] = stamp
 		}
+	}
+	return scans
+}
 
-		startIdx := len(index.Entries)
-		index.Entries = append(index.Entries, entries...)
-		categoryEntries[dir.category] += len(entries)
+// addLegacyEntries appends the entries of one source to the index.
+func addLegacyEntries(index *SearchIndex, category string, entries []ReleaseEntry, foundCategories map[string]bool, categoryEntries map[string]int) {
+	if len(entries) == 0 {
+		return
+	}
 
-		if !foundCategories[dir.category] {
-			foundCategories[dir.category] = true
-			index.CategoryOrder = append(index.CategoryOrder, dir.category)
-		}
+	startIdx := len(index.Entries)
+	index.Entries = append(index.Entries, entries...)
+	categoryEntries[category] += len(entries)
 
-		for i := startIdx; i < len(index.Entries); i++ {
-			index.ByCategory[dir.category] = append(index.ByCategory[dir.category], i)
-		}
+	// Track category.
+	if !foundCategories[category] {
+		foundCategories[category] = true
+		index.CategoryOrder = append(index.CategoryOrder, category)
+	}
+
+	// Update ByCategory map.
+	for i := startIdx; i < len(index.Entries); i++ {
+		index.ByCategory[category] = append(index.ByCategory[category], i)
 	}
 }
 
@@ -311,10 +462,7 @@ func loadAssembly64Index(basePath string) (*SearchIndex, error) {
 
 	// Known index file paths - complete hardcoded list from actual assembly64 directory.
 	// Format: {category, relative_path_to_releaselog}.
-	indexPaths := []struct {
-		category string
-		path     string
-	}{
+	indexPaths := []legacySource{
 		// Games
 		{"Games", "Games/CSDB/All/.releaselog.json"},
 		{"Games", "Games/CSDB/4k/.releaselog.json"},
@@ -346,17 +494,8 @@ func loadAssembly64Index(basePath string) (*SearchIndex, error) {
 		{"Misc", "Misc/Guybrush/.releaselog.json"},
 	}
 
-	foundCategories := make(map[string]bool)
-	categoryEntries := make(map[string]int)
-
-	// Load from index files.
-	processIndexPaths(basePath, indexPaths, index, foundCategories, categoryEntries)
-
 	// Directories without .releaselog.json - scan these directly.
-	noIndexDirs := []struct {
-		category string
-		path     string
-	}{
+	noIndexDirs := []legacySource{
 		{"Games", "Games/Gamebase"},
 		{"Games", "Games/Guybrush"},
 		{"Games", "Games/C64Tapes-org"},
@@ -367,7 +506,39 @@ func loadAssembly64Index(basePath string) (*SearchIndex, error) {
 		{"Games", "Games/Preservers"},
 	}
 
-	processNoIndexDirs(basePath, noIndexDirs, index, foundCategories, categoryEntries)
+	// Load index files and scan directories concurrently, reusing what is unchanged since
+	// the last load, then merge in list order so entry indices do not depend on timing.
+	p := startPhase("legacy.cache")
+	cache := loadLegacyCache(basePath)
+	p.end()
+
+	p = startPhase("legacy.scan")
+	next := &legacyCache{Version: legacyCacheVersion}
+	var logs, scans [][]ReleaseEntry
+	runConcurrently(
+		func() { logs = loadReleaseLogs(basePath, indexPaths, cache, next) },
+		func() { scans = scanNoIndexDirs(basePath, noIndexDirs, cache, next) },
+	)
+	p.end()
+
+	// Only write the cache when a source was re-read, re-scanned or dropped.
+	if !next.reuses(cache) {
+		p = startPhase("legacy.save")
+		next.save(basePath)
+		p.end()
+	}
+
+	p = startPhase("legacy.merge")
+	foundCategories := make(map[string]bool)
+	categoryEntries := make(map[string]int)
+	for i, src := range indexPaths {
+		addLegacyEntries(index, src.category, logs[i], foundCategories, categoryEntries)
+	}
+	for i, src := range noIndexDirs {
+		addLegacyEntries(index, src.category, scans[i], foundCategories, categoryEntries)
+	}
+	p.setEntries(len(index.Entries))
+	p.end()
 
 	// Log category summaries.
 	for _, cat := range index.CategoryOrder {
@@ -391,16 +562,25 @@ func isSupportedExtension(ext string) bool {
 	return false
 }
 
-// scanSingleDirectory scans a specific directory for loadable files (one level only, fast).
-func scanSingleDirectory(dirPath, categoryName string) []ReleaseEntry {
+// scanSingleDirectory scans a directory tree for loadable files, one entry per directory.
+// It also returns the modification time of every directory walked, in Unix nanoseconds,
+// so the scan can be revalidated without walking the tree again.
+func scanSingleDirectory(dirPath, categoryName string) ([]ReleaseEntry, map[string]int64) {
 	entries := make([]ReleaseEntry, 0, 5000)
 	seen := make(map[string]bool, 5000)
+	dirs := make(map[string]int64)
 
 	filepath.WalkDir(dirPath, func(path string, d os.DirEntry, err error) error {
-		if err != nil || d.IsDir() {
-			if d.IsDir() && d.Name()[0] == '.' {
+		if err != nil {
+			return nil
+		}
+		if d.IsDir() {
+			if d.Name()[0] == '.' && path != dirPath {
 				return filepath.SkipDir
 			}
+			if info, err := d.Info(); err == nil {
+				dirs[path] = info.ModTime().UnixNano()
+			}
 			return nil
 		}
 
@@ -434,14 +614,15 @@ func scanSingleDirectory(dirPath, categoryName string) []ReleaseEntry {
 		return nil
 	})
 
-	return entries
+	return entries, dirs
 }
 
-// loadReleaseLog loads a single .releaselog.json file.
-func loadReleaseLog(jsonFile, categoryName string) ([]ReleaseEntry, error) {
+// readReleaseLog reads a single .releaselog.json file. Entry paths are joined to the
+// file's directory but not yet resolved, see resolveReleaseEntry.
+func readReleaseLog(jsonFile, categoryName string) ([]ReleaseEntry, error) {
 	data, err := os.ReadFile(jsonFile)
 	if err != nil {
-		return nil, fmt.Errorf("failed to read file: %w", err)
+		return nil, err
 	}
 
 	var entries []ReleaseEntry
@@ -451,50 +632,65 @@ func loadReleaseLog(jsonFile, categoryName string) ([]ReleaseEntry, error) {
 
 	// The .releaselog.json file directory is the base for relative paths.
 	jsonDir := filepath.Dir(jsonFile)
-	validEntries := make([]ReleaseEntry, 0, len(entries))
-
 	for i := range entries {
 		entries[i].CategoryName = categoryName
-		fullPath := filepath.Join(jsonDir, entries[i].Path)
-
-		// Check if path points to a directory - find first loadable file.
-		if info, err := os.Stat(fullPath); err == nil && info.IsDir() {
-			actualFile, fileErr := findLoadableFile(fullPath)
-			if fileErr != nil {
-				// Skip entries without loadable files.
-				continue
-			}
-			fullPath = actualFile
-		} else if err != nil {
-			// File doesn't exist, skip.
-			continue
-		}
+		entries[i].FullPath = filepath.Join(jsonDir, entries[i].Path)
+	}
+	return entries, nil
+}
 
-		entries[i].FullPath = fullPath
-		entries[i].FileType = strings.TrimPrefix(strings.ToLower(filepath.Ext(fullPath)), ".")
-		validEntries = append(validEntries, entries[i])
+// resolveReleaseEntry resolves the path of an entry read by readReleaseLog to a loadable
+// file, and reports false if there is none.
+func resolveReleaseEntry(entry *ReleaseEntry) bool {
+	info, err := os.Stat(entry.FullPath)
+	if err != nil {
+		// File doesn't exist, skip.
+		return false
 	}
 
-	return validEntries, nil
+	// Check if path points to a directory - find first loadable file.
+	if info.IsDir() {
+		actualFile, err := findLoadableFile(entry.FullPath)
+		if err != nil {
+			// Skip entries without loadable files.
+			return false
+		}
+		entry.FullPath = actualFile
+	}
+
+	entry.FileType = strings.TrimPrefix(strings.ToLower(filepath.Ext(entry.FullPath)), ".")
+	return true
+}
+
+// loadableExtPriority ranks loadable file extensions: .d64, .prg, .crt, other disk images.
+var loadableExtPriority = map[string]int{
+	".d64": 0, ".prg": 1, ".crt": 2, ".d71": 3, ".d81": 4, ".g64": 5, ".g71": 6,
 }
 
-// findLoadableFile finds the first loadable C64 file in a directory.
+// findLoadableFile finds the first loadable C64 file in a directory, by extension priority.
 func findLoadableFile(dirPath string) (string, error) {
 	entries, err := os.ReadDir(dirPath)
 	if err != nil {
 		return "", fmt.Errorf("failed to read directory: %w", err)
 	}
 
-	// Priority order: .d64, .prg, .crt, other disk images.
-	exts := []string{".d64", ".prg", ".crt", ".d71", ".d81", ".g64", ".g71"}
-
-	for _, ext := range exts {
-		for _, entry := range entries {
-			if !entry.IsDir() && strings.EqualFold(filepath.Ext(entry.Name()), ext) {
-				return filepath.Join(dirPath, entry.Name()), nil
-			}
+	// One pass, keeping the first file of the best priority seen.
+	best, bestRank := "", len(loadableExtPriority)
+	for _, entry := range entries {
+		if entry.IsDir() {
+			continue
+		}
+		rank, ok := loadableExtPriority[strings.ToLower(filepath.Ext(entry.Name()))]
+		if !ok || rank >= bestRank {
+			continue
+		}
+		best, bestRank = entry.Name(), rank
+		if rank == 0 {
+			break
 		}
 	}
-
-	return "", fmt.Errorf("no loadable file found in directory")
+	if best == "" {
+		return "", fmt.Errorf("no loadable file found in directory")
+	}
+	return filepath.Join(dirPath, best), nil
 }
@@ -0,0 +1,87 @@
+// Alphabetical jump index for LIST.
+// For each category and sort order, the offset of the first entry whose title starts
+// with each one- and two-character prefix is computed once, so a client can reach the
+// titles starting with "T" of a large category with one JUMP instead of paging there.
+package main
+
+import (
+	"sort"
+	"strings"
+	"unicode/utf8"
+)
+
+// jumpMaxPrefix is the longest prefix, in characters, that the jump index resolves.
+const jumpMaxPrefix = 2
+
+// jumpTable maps lowercased title prefixes to the first position of a sorted view.
+type jumpTable struct {
+	first map[string]int
+}
+
+// titlePrefix returns the first n characters of a lowercased title.
+func titlePrefix(name string, n int) string {
+	end := 0
+	for i := 0; i < n && end < len(name); i++ {
+		_, size := utf8.DecodeRuneInString(name[end:])
+		end += size
+	}
+	return name[:end]
+}
+
+// buildJumpTable records the first position of every title prefix in a view.
+func buildJumpTable(view []int, names []string) *jumpTable {
+	t := &jumpTable{first: make(map[string]int)}
+	for pos, i := range view {
+		for n := 1; n <= jumpMaxPrefix; n++ {
+			p := titlePrefix(names[i], n)
+			if _, ok := t.first[p]; !ok && p != "" {
+				t.first[p] = pos
+			}
+		}
+	}
+	return t
+}
+
+// categoryJumps returns the jump table of a category view, building it on first use.
+func (index *SearchIndex) categoryJumps(category string, key sortKey) (*jumpTable, []int) {
+	view := index.sortedView(category, key)
+	names := index.facets().names
+
+	viewKey := category + "\x00" + key.String()
+	index.sorts.mu.Lock()
+	t := index.sorts.jumps[viewKey]
+	index.sorts.mu.Unlock()
+	if t != nil {
+		return t, view
+	}
+
+	t = buildJumpTable(view, names)
+
+	index.sorts.mu.Lock()
+	defer index.sorts.mu.Unlock()
+	if existing := index.sorts.jumps[viewKey]; existing != nil {
+		return existing, view
+	}
+	if index.sorts.jumps == nil {
+		index.sorts.jumps = make(map[string]*jumpTable)
+	}
+	index.sorts.jumps[viewKey] = t
+	return t, view
+}
+
+// jumpOffset returns the position in a category view of the first title starting with
+// prefix (case-insensitive). In title order a prefix without titles resolves to the
+// next title after it; in other orders it is not found.
+func (index *SearchIndex) jumpOffset(category string, key sortKey, prefix string) (int, bool) {
+	prefix = strings.ToLower(prefix)
+	t, view := index.categoryJumps(category, key)
+	if pos, ok := t.first[prefix]; ok {
+		return pos, true
+	}
+	if key != sortTitle || len(view) == 0 {
+		return 0, false
+	}
+	names := index.facets().names
+	pos := sort.Search(len(view), func(k int) bool { return names[view[k]] >= prefix })
+	return min(pos, len(view)-1), true
+}
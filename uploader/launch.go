@@ -0,0 +1,294 @@
+// Staged, cancellable launches of entries on the C64 Ultimate.
+// A launch passes through read, extract, upload, mount and run phases, reports
+// transferred bytes and per-phase timings, and stops as soon as its context is cancelled.
+package main
+
+import (
+	"bytes"
+	"context"
+	"crypto/sha256"
+	"fmt"
+	"log/slog"
+	"strings"
+	"sync"
+	"time"
+)
+
+// launchPhase is one stage of launching an entry.
+type launchPhase int
+
+const (
+	phaseRead    launchPhase = iota // Reading the file from disk.
+	phaseExtract                    // Extracting the first PRG from a disk image.
+	phaseUpload                     // Uploading a disk image via FTP.
+	phaseMount                      // Mounting the uploaded disk image.
+	phaseRun                        // Sending the program to the runner.
+	phaseCount                      // Sentinel for phase count.
+)
+
+// launchPhaseNames are the display names of the launch phases.
+var launchPhaseNames = [phaseCount]string{"read", "extract", "upload", "mount", "run"}
+
+// launchEvent reports the current phase of a launch and, while data is being sent,
+// the number of bytes transferred.
+type launchEvent struct {
+	phase launchPhase
+	done  int64
+	total int64 // Zero when the phase transfers no data.
+}
+
+// launchTracker records phase timings of one launch and forwards progress events.
+// A nil tracker ignores all calls.
+type launchTracker struct {
+	report  func(launchEvent)
+	phase   launchPhase
+	started time.Time
+	entered [phaseCount]bool
+	timings [phaseCount]time.Duration
+}
+
+// newLaunchTracker creates a tracker that sends events to report.
+func newLaunchTracker(report func(launchEvent)) *launchTracker {
+	return &launchTracker{report: report}
+}
+
+// enter ends the current phase and starts the given one.
+func (t *launchTracker) enter(phase launchPhase) {
+	if t == nil {
+		return
+	}
+	t.stop()
+	t.phase = phase
+	t.started = time.Now()
+	t.entered[phase] = true
+	t.report(launchEvent{phase: phase})
+}
+
+// progress reports bytes transferred in the current phase.
+func (t *launchTracker) progress(done, total int64) {
+	if t == nil {
+		return
+	}
+	t.report(launchEvent{phase: t.phase, done: done, total: total})
+}
+
+// stop adds the time spent in the current phase to its timing.
+func (t *launchTracker) stop() {
+	if t == nil || t.started.IsZero() {
+		return
+	}
+	t.timings[t.phase] += time.Since(t.started)
+	t.started = time.Time{}
+}
+
+// summary ends the current phase and returns the timings of all entered phases,
+// e.g. "read 2ms, upload 410ms, mount 95ms, run 61ms".
+func (t *launchTracker) summary() string {
+	if t == nil {
+		return ""
+	}
+	t.stop()
+	var parts []string
+	for phase := launchPhase(0); phase < phaseCount; phase++ {
+		if t.entered[phase] {
+			parts = append(parts, fmt.Sprintf("%s %s", launchPhaseNames[phase], t.timings[phase].Round(time.Millisecond)))
+		}
+	}
+	return strings.Join(parts, ", ")
+}
+
+// progressReader reads data while reporting progress to a tracker, and fails
+// with the context's error once the context is cancelled.
+type progressReader struct {
+	ctx     context.Context
+	r       *bytes.Reader
+	done    int64
+	total   int64
+	tracker *launchTracker
+}
+
+// newProgressReader returns a reader over data that reports to tracker.
+func newProgressReader(ctx context.Context, data []byte, tracker *launchTracker) *progressReader {
+	return &progressReader{ctx: ctx, r: bytes.NewReader(data), total: int64(len(data)), tracker: tracker}
+}
+
+// Read implements io.Reader.
+func (p *progressReader) Read(b []byte) (int, error) {
+	if err := p.ctx.Err(); err != nil {
+		return 0, err
+	}
+	n, err := p.r.Read(b)
+	if n > 0 {
+		p.done += int64(n)
+		p.tracker.progress(p.done, p.total)
+	}
+	return n, err
+}
+
+// runnerEndpoints maps single-file types to their runner endpoints.
+var runnerEndpoints = map[string]string{
+	"prg": "/v1/runners:run_prg",
+	"crt": "/v1/runners:run_crt",
+	"sid": "/v1/runners:sidplay",
+}
+
+// lockDevice waits until no other launch uses the device and takes it. A cancelled
+// launch stops at its next request or upload chunk, so a new launch waits only briefly
+// for the one it pre-empted. It fails if ctx is cancelled while waiting.
+func (c *APIClient) lockDevice(ctx context.Context) error {
+	c.deviceMu.Lock()
+	if err := ctx.Err(); err != nil {
+		c.deviceMu.Unlock()
+		return err
+	}
+	return nil
+}
+
+// launch runs file data of the given type on the C64 Ultimate, reporting each phase to
+// tracker (which may be nil). Cancelling ctx aborts the launch at the next request or
+// upload chunk.
+func (c *APIClient) launch(ctx context.Context, fileData []byte, fileType, filename string, tracker *launchTracker) error {
+	if err := c.lockDevice(ctx); err != nil {
+		return err
+	}
+	defer c.deviceMu.Unlock()
+
+	switch fileType {
+	case "d64", "d71", "d81", "g64", "g71":
+		return c.launchDiskImageLocked(ctx, fileData, fileType, filename, prgLocation{file: firstPRGFile}, tracker)
+	}
+
+	endpoint, ok := runnerEndpoints[fileType]
+	if !ok {
+		return fmt.Errorf("unsupported file type: %s", fileType)
+	}
+
+	slog.Info("Uploading and running file", "type", fileType, "size", len(fileData))
+	tracker.enter(phaseRun)
+	return c.doRequestContext(ctx, "POST", endpoint, newProgressReader(ctx, fileData, tracker))
+}
+
+// launchDiskImage mounts a disk image and runs the PRG at loc via DMA.
+func (c *APIClient) launchDiskImage(ctx context.Context, fileData []byte, imageType, filename string, loc prgLocation, tracker *launchTracker) error {
+	if err := c.lockDevice(ctx); err != nil {
+		return err
+	}
+	defer c.deviceMu.Unlock()
+	return c.launchDiskImageLocked(ctx, fileData, imageType, filename, loc, tracker)
+}
+
+// launchDiskImageLocked is launchDiskImage for a caller holding the device.
+func (c *APIClient) launchDiskImageLocked(ctx context.Context, fileData []byte, imageType, filename string, loc prgLocation, tracker *launchTracker) error {
+	// Extract the PRG file from disk image.
+	tracker.enter(phaseExtract)
+	prgData, prgFilename, err := extractPRG(fileData, imageType, loc)
+	if err != nil {
+		return fmt.Errorf("extracting PRG from disk image: %w", err)
+	}
+
+	slog.Info("Extracted PRG from disk", "filename", prgFilename, "size", len(prgData), "imageType", imageType)
+
+	// Skip the upload if this image, or a mirror of it, is still in /Temp.
+	tracker.enter(phaseUpload)
+	sum := sha256.Sum256(fileData)
+	remotePath, reused := c.uploadedPath(ctx, sum, len(fileData))
+	if reused {
+		slog.Info("Disk image already uploaded, skipping upload", "path", remotePath)
+	} else if remotePath, err = c.uploadDisk(ctx, fileData, imageType, sum, tracker); err != nil {
+		return err
+	}
+
+	// Mount the disk image from filesystem for multi-file support.
+	tracker.enter(phaseMount)
+	err = c.mountDisk(ctx, remotePath, imageType)
+	if err != nil && reused && ctx.Err() == nil {
+		// The file may have changed since it was checked; upload it again and retry once.
+		slog.Info("Mounting the uploaded disk image failed, uploading it again", "error", err)
+		tracker.enter(phaseUpload)
+		if remotePath, err = c.uploadDisk(ctx, fileData, imageType, sum, tracker); err != nil {
+			return err
+		}
+		tracker.enter(phaseMount)
+		err = c.mountDisk(ctx, remotePath, imageType)
+	}
+	if err != nil {
+		c.uploaded.reset()
+		return fmt.Errorf("mounting disk image: %w", err)
+	}
+
+	slog.Info("Disk image mounted to drive A")
+
+	// Run the extracted PRG via DMA for fastest startup.
+	tracker.enter(phaseRun)
+	return c.doRequestContext(ctx, "POST", runnerEndpoints["prg"], newProgressReader(ctx, prgData, tracker))
+}
+
+// uploadedPath returns the remote path of the image with content hash sum if it was
+// uploaded before and /Temp still holds a file of its size there.
+func (c *APIClient) uploadedPath(ctx context.Context, sum [sha256.Size]byte, size int) (string, bool) {
+	remotePath, ok := c.uploaded.lookup(sum)
+	if !ok {
+		return "", false
+	}
+	remoteSize, err := c.remoteFileSize(ctx, remotePath)
+	if err != nil || remoteSize != int64(size) {
+		slog.Info("Uploaded disk image is gone or changed, uploading it again", "path", remotePath, "size", remoteSize, "error", err)
+		c.uploaded.reset()
+		return "", false
+	}
+	return remotePath, true
+}
+
+// uploadDisk replaces the mounted disk image with fileData in /Temp and remembers it by
+// its content hash sum.
+func (c *APIClient) uploadDisk(ctx context.Context, fileData []byte, imageType string, sum [sha256.Size]byte, tracker *launchTracker) (string, error) {
+	// Remove previously mounted disk to free up space.
+	c.uploaded.reset()
+	if err := c.removeDisk(ctx); err != nil {
+		if ctx.Err() != nil {
+			return "", ctx.Err()
+		}
+		// Log but don't fail - disk might not be mounted.
+		slog.Debug("Failed to remove previous disk (may not be mounted)", "error", err)
+	}
+
+	// Upload disk image to /Temp via FTP using hardcoded filename to avoid filling /Temp.
+	hardcodedFilename := "uploaded_disk." + imageType
+	remotePath, err := c.uploadDiskViaFTP(ctx, fileData, hardcodedFilename, tracker)
+	if err != nil {
+		return "", fmt.Errorf("uploading disk via FTP: %w", err)
+	}
+	// Only a launch that was not cancelled may vouch for the uploaded file.
+	if err := ctx.Err(); err != nil {
+		return "", err
+	}
+	c.uploaded.store(sum, remotePath)
+	return remotePath, nil
+}
+
+// uploadedDisk remembers which disk image was last uploaded to /Temp, by content hash,
+// so relaunching the same image or one of its mirrors only has to mount it again.
+type uploadedDisk struct {
+	mu   sync.Mutex
+	sum  [sha256.Size]byte
+	path string // Remote path, or "" if unknown.
+}
+
+// lookup returns the remote path of the image with content hash sum if it is uploaded.
+func (u *uploadedDisk) lookup(sum [sha256.Size]byte) (string, bool) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	return u.path, u.path != "" && u.sum == sum
+}
+
+// store records that the image with content hash sum is uploaded at path.
+func (u *uploadedDisk) store(sum [sha256.Size]byte, path string) {
+	u.mu.Lock()
+	defer u.mu.Unlock()
+	u.sum, u.path = sum, path
+}
+
+// reset forgets the uploaded image.
+func (u *uploadedDisk) reset() {
+	u.store([sha256.Size]byte{}, "")
+}
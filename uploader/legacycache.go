@@ -0,0 +1,154 @@
+// Persistent cache of the legacy loader.
+// Resolved entries are saved per .releaselog.json file and per scanned directory tree,
+// together with the modification times they were derived from, so a refresh or restart
+// only re-reads and re-resolves the sources that changed.
+package main
+
+import (
+	"encoding/json"
+	"log/slog"
+	"os"
+	"path/filepath"
+)
+
+const (
+	// legacyCacheFile is the name of the legacy loader cache in the assembly64 directory.
+	legacyCacheFile = "c64uploader_legacy_cache.json"
+
+	// legacyCacheVersion is bumped whenever the cache layout or the resolution rules change.
+	legacyCacheVersion = 1
+)
+
+// legacyCache holds the resolved entries of all legacy sources by relative source path.
+type legacyCache struct {
+	Version int                          `json:"version"`
+	Logs    map[string]*legacyCachedLog  `json:"logs"`
+	Scans   map[string]*legacyCachedScan `json:"scans"`
+}
+
+// legacyCachedLog is the resolved content of one .releaselog.json file. It is valid while
+// the file's size and modification time are unchanged.
+type legacyCachedLog struct {
+	ModTime int64               `json:"mtime"` // Unix nanoseconds.
+	Size    int64               `json:"size"`
+	Entries []legacyCachedEntry `json:"entries"`
+}
+
+// legacyCachedScan is the result of scanning one unindexed directory tree. It is valid
+// while no directory of the tree has a new modification time, i.e. no file was added,
+// removed or renamed.
+type legacyCachedScan struct {
+	Dirs    map[string]int64    `json:"dirs"` // Directory path -> Unix nanoseconds.
+	Entries []legacyCachedEntry `json:"entries"`
+}
+
+// legacyCachedEntry is a resolved legacy entry.
+type legacyCachedEntry struct {
+	Name     string `json:"name"`
+	Group    string `json:"group,omitempty"`
+	Year     string `json:"year,omitempty"`
+	Path     string `json:"path,omitempty"`
+	ID       string `json:"id,omitempty"`
+	Type     string `json:"type,omitempty"`
+	Category int    `json:"category,omitempty"`
+	FullPath string `json:"fullPath"`
+	FileType string `json:"fileType"`
+}
+
+// loadLegacyCache reads the legacy cache of an assembly64 directory. A missing, corrupt
+// or outdated cache yields an empty one.
+func loadLegacyCache(basePath string) *legacyCache {
+	empty := &legacyCache{Version: legacyCacheVersion}
+	data, err := os.ReadFile(filepath.Join(basePath, legacyCacheFile))
+	if err != nil {
+		return empty
+	}
+	var c legacyCache
+	if err := json.Unmarshal(data, &c); err != nil || c.Version != legacyCacheVersion {
+		slog.Debug("Ignoring legacy cache", "error", err, "version", c.Version)
+		return empty
+	}
+	return &c
+}
+
+// save writes the cache to the assembly64 directory. Failures, e.g. on a read-only
+// collection, only cost the next startup a full scan.
+func (c *legacyCache) save(basePath string) {
+	data, err := json.Marshal(c)
+	if err == nil {
+		err = os.WriteFile(filepath.Join(basePath, legacyCacheFile), data, 0644)
+	}
+	if err != nil {
+		slog.Debug("Failed to save legacy cache", "error", err)
+	}
+}
+
+// reuses reports whether c holds the same sources as old, all taken from old unchanged,
+// so saving c would only rewrite the cache file as it is.
+func (c *legacyCache) reuses(old *legacyCache) bool {
+	if len(c.Logs) != len(old.Logs) || len(c.Scans) != len(old.Scans) {
+		return false
+	}
+	for path, l := range c.Logs {
+		if old.Logs[path] != l {
+			return false
+		}
+	}
+	for path, s := range c.Scans {
+		if old.Scans[path] != s {
+			return false
+		}
+	}
+	return true
+}
+
+// matches reports whether a cached release log is still valid for the file info.
+func (l *legacyCachedLog) matches(info os.FileInfo) bool {
+	return l != nil && l.Size == info.Size() && l.ModTime == info.ModTime().UnixNano()
+}
+
+// valid reports whether no directory of a cached scan changed, statting them in parallel.
+func (s *legacyCachedScan) valid() bool {
+	if s == nil {
+		return false
+	}
+	dirs := make([]string, 0, len(s.Dirs))
+	for dir := range s.Dirs {
+		dirs = append(dirs, dir)
+	}
+	changed := make([]bool, len(dirs))
+	runParallelN(legacyScanWorkers, len(dirs), func(i int) {
+		info, err := os.Stat(dirs[i])
+		changed[i] = err != nil || info.ModTime().UnixNano() != s.Dirs[dirs[i]]
+	})
+	for _, c := range changed {
+		if c {
+			return false
+		}
+	}
+	return true
+}
+
+// cacheEntries converts resolved entries for the cache.
+func cacheEntries(entries []ReleaseEntry) []legacyCachedEntry {
+	cached := make([]legacyCachedEntry, len(entries))
+	for i, e := range entries {
+		cached[i] = legacyCachedEntry{
+			Name: e.Name, Group: e.Group, Year: e.Year, Path: e.Path, ID: e.ID, Type: e.Type,
+			Category: e.Category, FullPath: e.FullPath, FileType: e.FileType,
+		}
+	}
+	return cached
+}
+
+// releaseEntries converts cached entries back to entries of the given category.
+func releaseEntries(cached []legacyCachedEntry, categoryName string) []ReleaseEntry {
+	entries := make([]ReleaseEntry, len(cached))
+	for i, e := range cached {
+		entries[i] = ReleaseEntry{
+			Name: e.Name, Group: e.Group, Year: e.Year, Path: e.Path, ID: e.ID, Type: e.Type,
+			Category: e.Category, CategoryName: categoryName, FullPath: e.FullPath, FileType: e.FileType,
+		}
+	}
+	return entries
+}
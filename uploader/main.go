@@ -4,6 +4,7 @@
 package main
 
 import (
+	"context"
 	"flag"
 	"fmt"
 	"io"
@@ -152,6 +153,9 @@ func printUsage() {
 // assembly64Path should already be expanded (no ~).
 // It looks for c64uploader_games.json, c64uploader_demos.json, c64uploader_music.json, etc. and merges them.
 func loadIndex(assembly64Path string, forceLegacy bool) (*SearchIndex, error) {
+	p := startPhase("loadIndex")
+	defer p.end()
+
 	if forceLegacy {
 		// Fall back to legacy .releaselog.json loading.
 		return loadAssembly64Index(assembly64Path)
@@ -187,7 +191,9 @@ func runTUI(args []string) {
 	verbose := fs.Bool("v", false, "Enable verbose debug logging")
 	assembly64Path := fs.String("assembly64", "~/Downloads/assembly64", "Path to Assembly64 data directory")
 	legacy := fs.Bool("legacy", false, "Force legacy .releaselog.json loading")
+	trace := fs.String("trace", "", "Write startup phase timings to a Chrome trace file")
 	fs.Parse(args)
+	startTrace(*trace)
 
 	// Set log level.
 	if *verbose {
@@ -209,6 +215,8 @@ func runTUI(args []string) {
 		fmt.Fprintf(os.Stderr, "Error: Failed to load index: %v\n", err)
 		os.Exit(1)
 	}
+	finishTrace(*trace)
+	index.warmCaches()
 
 	// Determine if we're in legacy mode (no JSON files found or -legacy flag).
 	legacyMode := *legacy
@@ -390,14 +398,14 @@ func runFTP(args []string) {
 
 	// Use the existing FTP upload method but with custom destination.
 	ftpAddr := fmt.Sprintf("%s:21", *host)
-	conn, err := client.ftpConnect(ftpAddr)
+	conn, err := client.ftpConnect(context.Background(), ftpAddr)
 	if err != nil {
 		fmt.Fprintf(os.Stderr, "Failed to connect to FTP server: %v\n", err)
 		os.Exit(1)
 	}
 	defer conn.Quit()
 
-	if err := client.ftpUpload(conn, fileData, destination); err != nil {
+	if err := client.ftpUpload(context.Background(), conn, fileData, destination, nil); err != nil {
 		fmt.Fprintf(os.Stderr, "Failed to upload file: %v\n", err)
 		os.Exit(1)
 	}
@@ -412,7 +420,9 @@ func runServer(args []string) {
 	assembly64Path := fs.String("assembly64", "~/Downloads/assembly64", "Path to Assembly64 data directory")
 	legacy := fs.Bool("legacy", false, "Force legacy .releaselog.json loading")
 	port := fs.Int("port", 6465, "C64 protocol server port")
+	trace := fs.String("trace", "", "Write startup phase timings to a Chrome trace file")
 	fs.Parse(args)
+	startTrace(*trace)
 
 	// Set log level.
 	if *verbose {
@@ -431,6 +441,8 @@ func runServer(args []string) {
 		slog.Error("Failed to load index", "error", err)
 		os.Exit(1)
 	}
+	finishTrace(*trace)
+	index.warmCaches()
 
 	// Create API client.
 	apiClient := NewAPIClient(*host)
@@ -449,7 +461,9 @@ func runDBGen(args []string) {
 	fs := flag.NewFlagSet("dbgen", flag.ExitOnError)
 	assembly64Path := fs.String("assembly64", "", "Path to Assembly64 data directory (required)")
 	category := fs.String("category", "all", "Category to generate: games, demos, music, or all (default: all)")
+	trace := fs.String("trace", "", "Write generation phase timings to a Chrome trace file")
 	fs.Parse(args)
+	startTrace(*trace)
 
 	if *assembly64Path == "" {
 		fmt.Fprintf(os.Stderr, "Error: -assembly64 path is required\n")
@@ -514,6 +528,8 @@ func runDBGen(args []string) {
 		os.Exit(1)
 	}
 
+	finishTrace(*trace)
+
 	if hasError {
 		os.Exit(1)
 	}
@@ -0,0 +1,125 @@
+// Compressed storage of entry paths.
+// Release directories of the JSON database share long prefixes such as
+// "Games/CSDB/All/T/...", so they are interned as a trie of path segments and each
+// entry keeps only a node reference and its file name. Absolute paths are built on
+// demand from the collection directory, which keeps the index relocatable.
+package main
+
+import (
+	"path/filepath"
+	"strings"
+)
+
+// pathRef references a directory node of a pathTable; pathNone means no table path.
+type pathRef int32
+
+const (
+	pathNone pathRef = 0 // Entry paths are stored in the entry (legacy mode).
+	pathRoot pathRef = 1 // The empty path.
+)
+
+// pathNode is one path segment; the path of a node is its parent's path plus its name.
+type pathNode struct {
+	parent pathRef
+	name   string
+}
+
+// pathKey identifies a child node during interning.
+type pathKey struct {
+	parent pathRef
+	name   string
+}
+
+// pathTable is a trie of interned directory paths.
+type pathTable struct {
+	nodes    []pathNode
+	children map[pathKey]pathRef // Only needed while interning; dropped by seal.
+}
+
+// intern returns the node of a slash-separated relative directory path, adding nodes
+// for segments not seen before.
+func (t *pathTable) intern(path string) pathRef {
+	if t.nodes == nil {
+		t.nodes = []pathNode{{}, {}} // pathNone, pathRoot.
+	}
+	if t.children == nil {
+		t.rebuildChildren()
+	}
+
+	node := pathRoot
+	for path != "" {
+		name, rest, _ := strings.Cut(path, "/")
+		path = rest
+		if name == "" {
+			continue
+		}
+		key := pathKey{parent: node, name: name}
+		child, ok := t.children[key]
+		if !ok {
+			// Clone, so the node does not keep the whole decoded path alive.
+			name = strings.Clone(name)
+			child = pathRef(len(t.nodes))
+			t.nodes = append(t.nodes, pathNode{parent: node, name: name})
+			t.children[pathKey{parent: node, name: name}] = child
+		}
+		node = child
+	}
+	return node
+}
+
+// seal drops the interning map and spare node capacity once all paths are added.
+// Interning again rebuilds the map.
+func (t *pathTable) seal() {
+	t.children = nil
+	if cap(t.nodes) > len(t.nodes) {
+		t.nodes = append([]pathNode(nil), t.nodes...)
+	}
+}
+
+// rebuildChildren builds the interning map from the nodes, e.g. after seal.
+func (t *pathTable) rebuildChildren() {
+	t.children = make(map[pathKey]pathRef, len(t.nodes))
+	for i := int(pathRoot) + 1; i < len(t.nodes); i++ {
+		n := t.nodes[i]
+		t.children[pathKey{parent: n.parent, name: n.name}] = pathRef(i)
+	}
+}
+
+// path returns the slash-separated relative path of a node.
+func (t *pathTable) path(ref pathRef) string {
+	if ref <= pathRoot || int(ref) >= len(t.nodes) {
+		return ""
+	}
+	n := 0
+	for r := ref; r > pathRoot; r = t.nodes[r].parent {
+		n += len(t.nodes[r].name) + 1
+	}
+	buf := make([]byte, n-1)
+	pos := len(buf)
+	for r := ref; r > pathRoot; r = t.nodes[r].parent {
+		name := t.nodes[r].name
+		pos -= len(name)
+		copy(buf[pos:], name)
+		if pos > 0 {
+			pos--
+			buf[pos] = '/'
+		}
+	}
+	return string(buf)
+}
+
+// relPath returns the directory of an entry relative to the collection directory.
+func (index *SearchIndex) relPath(e *ReleaseEntry) string {
+	if e.dir == pathNone {
+		return e.Path
+	}
+	return index.paths.path(e.dir)
+}
+
+// fullPath returns the absolute path of an entry's file.
+func (index *SearchIndex) fullPath(e *ReleaseEntry) string {
+	if e.dir == pathNone {
+		return e.FullPath
+	}
+	return filepath.Join(index.basePath, filepath.FromSlash(index.paths.path(e.dir)), e.file)
+}
@@ -0,0 +1,169 @@
+// Phase timing for index loading and database generation.
+// Each phase logs its duration, throughput, allocations and GC pauses via slog, and is
+// optionally recorded to a Chrome trace file (chrome://tracing, Perfetto) with -trace.
+package main
+
+import (
+	"encoding/json"
+	"fmt"
+	"log/slog"
+	"os"
+	"runtime"
+	"sync"
+	"time"
+)
+
+// phase measures one stage of startup or database generation. Phases are started and
+// ended on one goroutine; nested phases show up nested in the trace.
+type phase struct {
+	name    string
+	start   time.Time
+	mem     runtime.MemStats
+	bytes   int64
+	entries int
+}
+
+// startPhase starts measuring a phase.
+func startPhase(name string) *phase {
+	p := &phase{name: name}
+	runtime.ReadMemStats(&p.mem)
+	p.start = time.Now()
+	return p
+}
+
+// addBytes adds to the number of bytes the phase read or wrote.
+func (p *phase) addBytes(n int64) {
+	p.bytes += n
+}
+
+// setEntries sets the number of entries the phase produced.
+func (p *phase) setEntries(n int) {
+	p.entries = n
+}
+
+// end logs the phase and records it in the trace, if one is enabled.
+func (p *phase) end() {
+	elapsed := time.Since(p.start)
+	var mem runtime.MemStats
+	runtime.ReadMemStats(&mem)
+
+	stats := map[string]any{
+		"alloc_bytes": mem.TotalAlloc - p.mem.TotalAlloc,
+		"allocs":      mem.Mallocs - p.mem.Mallocs,
+		"gc_cycles":   mem.NumGC - p.mem.NumGC,
+		"gc_pause_us": (mem.PauseTotalNs - p.mem.PauseTotalNs) / 1000,
+	}
+	attrs := []any{
+		"phase", p.name,
+		"elapsed", elapsed.Round(time.Microsecond),
+		"alloc_bytes", stats["alloc_bytes"],
+		"allocs", stats["allocs"],
+		"gc_cycles", stats["gc_cycles"],
+		"gc_pause", time.Duration(mem.PauseTotalNs - p.mem.PauseTotalNs),
+	}
+	seconds := elapsed.Seconds()
+	if p.bytes > 0 {
+		stats["bytes"] = p.bytes
+		attrs = append(attrs, "bytes", p.bytes)
+		if seconds > 0 {
+			attrs = append(attrs, "mb_per_sec", fmt.Sprintf("%.1f", float64(p.bytes)/(1<<20)/seconds))
+		}
+	}
+	if p.entries > 0 {
+		stats["entries"] = p.entries
+		attrs = append(attrs, "entries", p.entries)
+		if seconds > 0 {
+			attrs = append(attrs, "entries_per_sec", int(float64(p.entries)/seconds))
+		}
+	}
+	slog.Info("Phase done", attrs...)
+
+	phaseTrace.record(p.name, p.start, elapsed, stats)
+}
+
+// traceEvent is a complete event of the Chrome trace event format.
+type traceEvent struct {
+	Name  string         `json:"name"`
+	Phase string         `json:"ph"`
+	TS    int64          `json:"ts"`  // Start in microseconds.
+	Dur   int64          `json:"dur"` // Duration in microseconds.
+	PID   int            `json:"pid"`
+	TID   int            `json:"tid"`
+	Args  map[string]any `json:"args,omitempty"`
+}
+
+// traceRecorder collects phases for a Chrome trace file.
+type traceRecorder struct {
+	mu      sync.Mutex
+	enabled bool
+	origin  time.Time
+	events  []traceEvent
+}
+
+// phaseTrace is the process-wide trace recorder, enabled by -trace.
+var phaseTrace traceRecorder
+
+// enable starts recording phases.
+func (t *traceRecorder) enable() {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	t.enabled = true
+	t.origin = time.Now()
+}
+
+// record adds a phase to the trace if recording is enabled.
+func (t *traceRecorder) record(name string, start time.Time, elapsed time.Duration, args map[string]any) {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	if !t.enabled {
+		return
+	}
+	t.events = append(t.events, traceEvent{
+		Name:  name,
+		Phase: "X",
+		TS:    start.Sub(t.origin).Microseconds(),
+		Dur:   elapsed.Microseconds(),
+		PID:   1,
+		TID:   1,
+		Args:  args,
+	})
+}
+
+// write saves the recorded phases to a trace file. It does nothing if recording is disabled.
+func (t *traceRecorder) write(path string) error {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	if !t.enabled {
+		return nil
+	}
+	data, err := json.Marshal(struct {
+		TraceEvents     []traceEvent `json:"traceEvents"`
+		DisplayTimeUnit string       `json:"displayTimeUnit"`
+	}{t.events, "ms"})
+	if err != nil {
+		return fmt.Errorf("failed to marshal trace: %w", err)
+	}
+	if err := os.WriteFile(path, data, 0644); err != nil {
+		return fmt.Errorf("failed to write trace: %w", err)
+	}
+	return nil
+}
+
+// startTrace enables phase recording if a trace file was requested.
+func startTrace(path string) {
+	if path != "" {
+		phaseTrace.enable()
+	}
+}
+
+// finishTrace writes the recorded phases to the trace file, if one was requested.
+func finishTrace(path string) {
+	if path == "" {
+		return
+	}
+	if err := phaseTrace.write(path); err != nil {
+		slog.Error("Failed to write trace", "error", err)
+		return
+	}
+	slog.Info("Phase trace written", "path", path)
+}
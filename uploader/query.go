@@ -0,0 +1,301 @@
+// Query planning for searches over the SearchIndex.
+// An AdvancedSearch is compiled into candidate entries taken from facet indexes plus
+// an ordered list of typed predicates, and the same plan serves the TUI and the C64 server.
+package main
+
+import (
+	"sort"
+	"strconv"
+	"strings"
+)
+
+// Predicate costs, used to evaluate cheap checks before expensive ones.
+const (
+	costFlag      = 1 // Boolean or integer field check.
+	costCrackFlag = 2 // Scan of the crack flag list.
+	costSubstring = 4 // Substring search in a lowercased string.
+)
+
+// facetIndex holds posting lists (ascending entry indices) for exact-match fields
+// and lowercased copies of the searchable text fields.
+type facetIndex struct {
+	byCategory map[string][]int // Lowercased category name -> entries.
+	byFileType map[string][]int // Lowercased file type -> entries.
+	byLanguage map[string][]int
+	byRegion   map[string][]int
+	byEngine   map[string][]int
+	bySIDChips map[string][]int // Number of SID chips -> music entries.
+	top200     []int            // Entries with a Top200 rank.
+
+	names   []string // Lowercased entry names.
+	groups  []string // Lowercased entry groups.
+	authors []string // Lowercased composers: folder and SID header names, NUL-separated.
+}
+
+// facets returns the facet index, building it on first use.
+func (index *SearchIndex) facets() *facetIndex {
+	index.facetsOnce.Do(func() {
+		index.facetIdx = buildFacetIndex(index.Entries)
+	})
+	return index.facetIdx
+}
+
+// buildFacetIndex builds posting lists for all facets in a single pass over the entries.
+func buildFacetIndex(entries []ReleaseEntry) *facetIndex {
+	f := &facetIndex{
+		byCategory: make(map[string][]int),
+		byFileType: make(map[string][]int),
+		byLanguage: make(map[string][]int),
+		byRegion:   make(map[string][]int),
+		byEngine:   make(map[string][]int),
+		bySIDChips: make(map[string][]int),
+		names:      make([]string, len(entries)),
+		groups:     make([]string, len(entries)),
+		authors:    make([]string, len(entries)),
+	}
+
+	add := func(m map[string][]int, value string, i int) {
+		if value != "" {
+			key := strings.ToLower(value)
+			m[key] = append(m[key], i)
+		}
+	}
+
+	for i := range entries {
+		entry := &entries[i]
+		add(f.byCategory, entry.CategoryName, i)
+		add(f.byFileType, entry.FileType, i)
+		add(f.byLanguage, entry.Language, i)
+		add(f.byRegion, entry.Region, i)
+		add(f.byEngine, entry.Engine, i)
+		if entry.Top200Rank > 0 {
+			f.top200 = append(f.top200, i)
+		}
+		f.names[i] = strings.ToLower(entry.Name)
+		f.groups[i] = strings.ToLower(entry.Group)
+		f.authors[i] = strings.ToLower(entry.Author)
+		if sid := entry.SID; sid != nil {
+			add(f.bySIDChips, strconv.Itoa(sid.Chips), i)
+			if !strings.EqualFold(sid.Author, entry.Author) {
+				f.authors[i] += "\x00" + strings.ToLower(sid.Author)
+			}
+		}
+	}
+
+	return f
+}
+
+// predicate is one compiled filter criterion evaluated per entry index.
+type predicate struct {
+	cost  int
+	match func(i int) bool
+}
+
+// queryPlan is a compiled search: candidate entries and the predicates they must pass.
+type queryPlan struct {
+	candidates []int // Entries to test in ascending order; nil means the whole index.
+	preds      []predicate
+
+	query    string      // Lowercased text query, used for ranking.
+	typos    []int       // Ascending candidates whose title matches the query with typos.
+	typoDist map[int]int // Edit distance of each typo match.
+}
+
+// matches reports whether entry i passes all predicates of the plan.
+func (p *queryPlan) matches(i int) bool {
+	for _, pred := range p.preds {
+		if !pred.match(i) {
+			return false
+		}
+	}
+	return true
+}
+
+// run evaluates the plan against the index and returns matching entry indices in index order.
+func (p *queryPlan) run(index *SearchIndex) []int {
+	var results []int
+	if p.candidates == nil {
+		for i := range index.Entries {
+			if p.matches(i) {
+				results = append(results, i)
+			}
+		}
+		return results
+	}
+
+	for _, i := range p.candidates {
+		if p.matches(i) {
+			results = append(results, i)
+		}
+	}
+	return results
+}
+
+// compileSearch compiles search criteria into a query plan.
+// Exact-match criteria are answered from facet posting lists, intersected smallest first;
+// the remaining criteria become predicates ordered by cost.
+func compileSearch(index *SearchIndex, as AdvancedSearch) *queryPlan {
+	f := index.facets()
+	entries := index.Entries
+	plan := &queryPlan{}
+
+	// Facet lookups.
+	var postings [][]int
+	addFacet := func(m map[string][]int, value string) {
+		if value != "" {
+			postings = append(postings, m[strings.ToLower(value)])
+		}
+	}
+	if !strings.EqualFold(as.Category, "All") {
+		addFacet(f.byCategory, as.Category)
+	}
+	addFacet(f.byFileType, as.FileType)
+	addFacet(f.byLanguage, as.Language)
+	addFacet(f.byRegion, as.Region)
+	addFacet(f.byEngine, as.Engine)
+	addFacet(f.bySIDChips, as.SIDChips)
+	if as.Top200Only {
+		postings = append(postings, f.top200)
+	}
+	if len(postings) > 0 {
+		plan.candidates = intersectPostings(postings)
+	}
+
+	// Text predicates, with the needles lowercased once.
+	if query := strings.ToLower(as.Query); query != "" {
+		plan.query = query
+		plan.typos, plan.typoDist = findTypoMatches(index, query)
+		if plan.candidates != nil && plan.typos != nil {
+			plan.typos = intersectPostings([][]int{plan.typos, plan.candidates})
+		}
+		typoDist := plan.typoDist
+		plan.preds = append(plan.preds, predicate{costSubstring, func(i int) bool {
+			if strings.Contains(f.names[i], query) || strings.Contains(f.groups[i], query) || strings.Contains(f.authors[i], query) {
+				return true
+			}
+			_, ok := typoDist[i]
+			return ok
+		}})
+	}
+	if title := strings.ToLower(as.Title); title != "" {
+		plan.preds = append(plan.preds, predicate{costSubstring, func(i int) bool {
+			return strings.Contains(f.names[i], title)
+		}})
+	}
+	if group := strings.ToLower(as.Group); group != "" {
+		plan.preds = append(plan.preds, predicate{costSubstring, func(i int) bool {
+			return strings.Contains(f.groups[i], group)
+		}})
+	}
+	if author := strings.ToLower(as.Author); author != "" {
+		plan.preds = append(plan.preds, predicate{costSubstring, func(i int) bool {
+			return strings.Contains(f.authors[i], author)
+		}})
+	}
+
+	// Field predicates.
+	if as.Is4kOnly {
+		plan.preds = append(plan.preds, predicate{costFlag, func(i int) bool {
+			return entries[i].Is4k
+		}})
+	}
+	if as.IsCracked != nil {
+		wantCracked := *as.IsCracked
+		plan.preds = append(plan.preds, predicate{costFlag, func(i int) bool {
+			crack := entries[i].Crack
+			return (crack != nil && crack.IsCracked) == wantCracked
+		}})
+	}
+	if as.MinTrainers > 0 || as.MaxTrainers >= 0 || as.HasDocs || as.HasFastload {
+		minTrainers, maxTrainers := as.MinTrainers, as.MaxTrainers
+		plan.preds = append(plan.preds, predicate{costFlag, func(i int) bool {
+			crack := entries[i].Crack
+			if crack == nil {
+				return false
+			}
+			if minTrainers > 0 && crack.Trainers < minTrainers {
+				return false
+			}
+			return maxTrainers < 0 || crack.Trainers <= maxTrainers
+		}})
+	}
+	if as.HasDocs {
+		plan.preds = append(plan.preds, predicate{costCrackFlag, func(i int) bool {
+			return hasCrackFlag(entries[i].Crack, "docs")
+		}})
+	}
+	if as.HasFastload {
+		plan.preds = append(plan.preds, predicate{costCrackFlag, func(i int) bool {
+			return hasCrackFlag(entries[i].Crack, "fastload")
+		}})
+	}
+
+	sort.SliceStable(plan.preds, func(a, b int) bool {
+		return plan.preds[a].cost < plan.preds[b].cost
+	})
+
+	return plan
+}
+
+// intersectPostings intersects ascending posting lists, starting with the smallest.
+func intersectPostings(postings [][]int) []int {
+	sort.Slice(postings, func(a, b int) bool {
+		return len(postings[a]) < len(postings[b])
+	})
+
+	result := append([]int{}, postings[0]...)
+	for _, list := range postings[1:] {
+		if len(result) == 0 {
+			break
+		}
+		n, j := 0, 0
+		for _, v := range result {
+			for j < len(list) && list[j] < v {
+				j++
+			}
+			if j < len(list) && list[j] == v {
+				result[n] = v
+				n++
+			}
+		}
+		result = result[:n]
+	}
+	return result
+}
+
+// unionPostings merges two ascending posting lists without duplicates.
+func unionPostings(a, b []int) []int {
+	if len(b) == 0 {
+		return a
+	}
+	result := make([]int, 0, len(a)+len(b))
+	i, j := 0, 0
+	for i < len(a) || j < len(b) {
+		switch {
+		case j == len(b) || (i < len(a) && a[i] < b[j]):
+			result = append(result, a[i])
+			i++
+		case i == len(a) || b[j] < a[i]:
+			result = append(result, b[j])
+			j++
+		default:
+			result = append(result, a[i])
+			i++
+			j++
+		}
+	}
+	return result
+}
+
+// hasCrackFlag reports whether the crack info carries the given flag.
+func hasCrackFlag(crack *CrackInfo, flag string) bool {
+	if crack == nil {
+		return false
+	}
+	for _, f := range crack.Flags {
+		if f == flag {
+			return true
+		}
+	}
+	return false
+}
@@ -0,0 +1,39 @@
+// Memoized protocol responses.
+// CATS and INFO responses depend only on the loaded index, so each is formatted once
+// and then served as is. The cache lives on the SearchIndex, so a reloaded index
+// starts with an empty cache.
+package main
+
+import (
+	"sync"
+	"sync/atomic"
+)
+
+// responseCache holds formatted responses of one index.
+type responseCache struct {
+	catsOnce sync.Once
+	cats     string
+
+	infoOnce sync.Once
+	info     []atomic.Pointer[string] // INFO response by entry index; nil until first requested.
+}
+
+// catsResponse returns the CATS response, formatting it on first use.
+func (index *SearchIndex) catsResponse(build func() string) string {
+	c := &index.responses
+	c.catsOnce.Do(func() { c.cats = build() })
+	return c.cats
+}
+
+// infoResponse returns the INFO response of a valid entry id, formatting it on first use.
+// Concurrent first requests for one entry may both format it; either result is kept.
+func (index *SearchIndex) infoResponse(id int, build func() string) string {
+	c := &index.responses
+	c.infoOnce.Do(func() { c.info = make([]atomic.Pointer[string], len(index.Entries)) })
+	if r := c.info[id].Load(); r != nil {
+		return *r
+	}
+	r := build()
+	c.info[id].Store(&r)
+	return r
+}
@@ -11,20 +11,36 @@ import (
 	"strconv"
 	"strings"
 	"time"
+	"unicode/utf8"
 )
 
 // C64 protocol commands:
 // CATS                         - List categories
 // LIST <cat> <offset> <n>      - List n entries from category starting at offset
+// JUMP <cat> <prefix>          - Offset in LIST of the first title starting with a 1-2 char prefix
 // SEARCH <off> <n> <query>     - Search all entries (query can be multi-word)
 // SEARCH <off> <n> <cat> <q>   - Search within category (cat=All for all)
+// GROUPS <cat> <offset> <n>    - List n groups with entries in category, with their entry counts
+// BYGROUP <group> <offset> <n> - List n entries of a group, oldest first
+// BYAUTHOR <name> <offset> <n> - List n entries of a composer, oldest first
+// sort=<key>                   - Optional on LIST/JUMP/SEARCH/ADVSEARCH: title, group, year, top200, rating, party
 // INFO <id>                    - Get entry details
+// MINFO <id> [<id> ...]        - Get details of several entries in one reply
 // RUN <id>                     - Download and run entry
+// FACETS [key=value ...]       - Count matches per filter value (ADVSEARCH keys)
+// FRAME <size>                 - Write responses in chunks of whole lines of at most size bytes
+// BATCH <cmd> ; <cmd> ...      - Run several commands and return their responses in one reply
 // QUIT                         - Close connection
 
 const (
 	c64ReadTimeout = 5 * time.Minute
 	c64PageSize    = 20 // Default entries per page
+	c64MaxBatch    = 20 // Most IDs per MINFO and commands per BATCH
+
+	// Bounds of the FRAME chunk size. The C64 client reads at most 892 bytes per UCI
+	// socket read (UCI_DATA_QUEUE_SZ - 4).
+	c64MinFrame = 64
+	c64MaxFrame = 8192
 )
 
 // StartC64Server starts the C64 protocol server.
@@ -57,6 +73,8 @@ func handleC64Connection(conn net.Conn, index *SearchIndex, apiClient *APIClient
 	remoteAddr := conn.RemoteAddr().String()
 	slog.Info("C64 client connected", "remote", remoteAddr)
 
+	frame := 0 // Chunk size requested with FRAME; 0 writes each response at once.
+
 	// Send greeting
 	conn.Write([]byte("OK Assembly64 Browser\n"))
 
@@ -78,6 +96,15 @@ func handleC64Connection(conn net.Conn, index *SearchIndex, apiClient *APIClient
 
 		slog.Debug("C64 command", "remote", remoteAddr, "cmd", line)
 
+		// FRAME changes how this connection writes, so it is handled here.
+		if size, response, ok := parseFrameCommand(line); ok {
+			if size >= 0 {
+				frame = size
+			}
+			conn.Write([]byte(response))
+			continue
+		}
+
 		response := handleC64Command(line, index, apiClient, assembly64Path, conn)
 		if response == "QUIT" {
 			conn.Write([]byte("OK Goodbye\n"))
@@ -86,7 +113,52 @@ func handleC64Connection(conn net.Conn, index *SearchIndex, apiClient *APIClient
 		if strings.HasPrefix(response, "ERR") {
 			slog.Error("C64 client error", "remote", remoteAddr, "error", response, "command", line)
 		}
+		writeFramed(conn, response, frame)
+	}
+}
+
+// parseFrameCommand parses a FRAME command. ok is false for other commands. size is the
+// new chunk size (0 turns framing off), or -1 if the command was invalid.
+func parseFrameCommand(line string) (size int, response string, ok bool) {
+	parts := strings.Fields(line)
+	if len(parts) == 0 || !strings.EqualFold(parts[0], "FRAME") {
+		return 0, "", false
+	}
+	if len(parts) != 2 {
+		return -1, "ERR Usage: FRAME <size>\n", true
+	}
+	size, err := strconv.Atoi(parts[1])
+	if err != nil || size < 0 {
+		return -1, "ERR Invalid frame size\n", true
+	}
+	if size > 0 {
+		size = max(c64MinFrame, min(size, c64MaxFrame))
+	}
+	return size, fmt.Sprintf("OK %d\n", size), true
+}
+
+// writeFramed writes a response in chunks of at most frame bytes, each ending at a line
+// boundary where possible, so no chunk exceeds the client's read window or ends
+// mid-line. TCP may still merge or split chunks in transit. A frame of 0 writes the
+// response at once.
+func writeFramed(conn net.Conn, response string, frame int) {
+	if frame <= 0 {
 		conn.Write([]byte(response))
+		return
+	}
+	for len(response) > 0 {
+		n := len(response)
+		if n > frame {
+			n = frame
+			// Lines longer than a frame are split at the frame size.
+			if i := strings.LastIndexByte(response[:frame], '\n'); i >= 0 {
+				n = i + 1
+			}
+		}
+		if _, err := conn.Write([]byte(response[:n])); err != nil {
+			return
+		}
+		response = response[n:]
 	}
 }
 
@@ -98,6 +170,16 @@ func handleC64Command(line string, index *SearchIndex, apiClient *APIClient, ass
 
 	cmd := strings.ToUpper(parts[0])
 
+	// BATCH splits the raw line, as each command carries its own options.
+	if cmd == "BATCH" {
+		return handleBatch(strings.TrimSpace(line[len(parts[0]):]), index, apiClient, assembly64Path, conn)
+	}
+
+	parts, sortBy, err := extractSortOption(cmd, parts)
+	if err != nil {
+		return fmt.Sprintf("ERR %v\n", err)
+	}
+
 	switch cmd {
 	case "CATS":
 		return handleCats(index)
@@ -109,7 +191,35 @@ func handleC64Command(line string, index *SearchIndex, apiClient *APIClient, ass
 		category := parts[1]
 		offset, _ := strconv.Atoi(parts[2])
 		count, _ := strconv.Atoi(parts[3])
-		return handleList(index, category, offset, count)
+		return handleList(index, category, offset, count, sortBy)
+
+	case "JUMP":
+		if len(parts) < 3 {
+			return "ERR Usage: JUMP <category> <prefix>\n"
+		}
+		return handleJump(index, parts[1], parts[2], sortBy)
+
+	case "GROUPS":
+		if len(parts) < 4 {
+			return "ERR Usage: GROUPS <category> <offset> <count>\n"
+		}
+		offset, _ := strconv.Atoi(parts[2])
+		count, _ := strconv.Atoi(parts[3])
+		return handleGroups(index, parts[1], offset, count)
+
+	case "BYGROUP", "BYAUTHOR":
+		// The name may contain spaces; offset and count are the last two arguments.
+		if len(parts) < 4 {
+			return fmt.Sprintf("ERR Usage: %s <name> <offset> <count>\n", cmd)
+		}
+		name := strings.Join(parts[1:len(parts)-2], " ")
+		offset, _ := strconv.Atoi(parts[len(parts)-2])
+		count, _ := strconv.Atoi(parts[len(parts)-1])
+		list := &index.browse().groups
+		if cmd == "BYAUTHOR" {
+			list = &index.browse().authors
+		}
+		return handleBrowseEntries(index, list, name, offset, count)
 
 	case "SEARCH":
 		if len(parts) < 4 {
@@ -133,7 +243,7 @@ func handleC64Command(line string, index *SearchIndex, apiClient *APIClient, ass
 		}
 		// Query is all remaining parts joined with spaces
 		query := strings.Join(parts[queryStart:], " ")
-		return handleSearch(index, query, category, offset, count)
+		return handleSearch(index, query, category, offset, count, sortBy)
 
 	case "INFO":
 		if len(parts) < 2 {
@@ -145,34 +255,70 @@ func handleC64Command(line string, index *SearchIndex, apiClient *APIClient, ass
 		}
 		return handleInfo(index, id)
 
+	case "MINFO":
+		if len(parts) < 2 {
+			return "ERR Usage: MINFO <id> [<id> ...]\n"
+		}
+		if len(parts)-1 > c64MaxBatch {
+			return fmt.Sprintf("ERR At most %d IDs\n", c64MaxBatch)
+		}
+		ids := make([]int, len(parts)-1)
+		for i, arg := range parts[1:] {
+			id, err := strconv.Atoi(arg)
+			if err != nil {
+				return "ERR Invalid ID\n"
+			}
+			ids[i] = id
+		}
+		return handleMultiInfo(index, ids)
+
+	case "DIR":
+		if len(parts) < 2 {
+			return "ERR Usage: DIR <id>\n"
+		}
+		id, err := strconv.Atoi(parts[1])
+		if err != nil {
+			return "ERR Invalid ID\n"
+		}
+		return handleDir(index, id)
+
 	case "RUN":
 		if len(parts) < 2 {
-			return "ERR Usage: RUN <id>\n"
+			return "ERR Usage: RUN <id> [file#]\n"
 		}
 		id, err := strconv.Atoi(parts[1])
 		if err != nil {
 			return "ERR Invalid ID\n"
 		}
-		return handleRun(index, apiClient, assembly64Path, id)
+		file := firstPRGFile
+		if len(parts) > 2 {
+			file, err = strconv.Atoi(parts[2])
+			if err != nil || file < 0 {
+				return "ERR Invalid file number\n"
+			}
+		}
+		return handleRun(index, apiClient, assembly64Path, id, file)
 
 	case "ADVSEARCH":
 		// ADVSEARCH offset count key=value key=value ...
-		// Keys: cat, title, group, type, top200
+		// Keys: cat, title, group, author, type, lang, region, engine, sids, top200, sort
 		if len(parts) < 3 {
 			return "ERR Usage: ADVSEARCH <offset> <count> [key=value ...]\n"
 		}
 		offset, _ := strconv.Atoi(parts[1])
 		count, _ := strconv.Atoi(parts[2])
-		// Parse key=value pairs
-		params := make(map[string]string)
-		for i := 3; i < len(parts); i++ {
-			if idx := strings.Index(parts[i], "="); idx > 0 {
-				key := strings.ToLower(parts[i][:idx])
-				value := parts[i][idx+1:]
-				params[key] = value
+		params := parseParams(parts[3:])
+		if name, ok := params["sort"]; ok {
+			if sortBy, ok = parseSortKey(name); !ok {
+				return fmt.Sprintf("ERR Unknown sort key: %s\n", name)
 			}
 		}
-		return handleAdvSearch(index, params, offset, count)
+		return handleAdvSearch(index, params, offset, count, sortBy)
+
+	case "FACETS":
+		// FACETS key=value ...
+		// Keys as for ADVSEARCH.
+		return handleFacets(index, parseParams(parts[1:]))
 
 	case "QUIT":
 		return "QUIT"
@@ -182,7 +328,92 @@ func handleC64Command(line string, index *SearchIndex, apiClient *APIClient, ass
 	}
 }
 
+// handleBatch runs the ';'-separated commands of a BATCH line in order and returns
+// "OK <n>" followed by each command's response, which carries its own terminator.
+func handleBatch(commands string, index *SearchIndex, apiClient *APIClient, assembly64Path string, conn net.Conn) string {
+	var cmds []string
+	for _, c := range strings.Split(commands, ";") {
+		if c = strings.TrimSpace(c); c != "" {
+			cmds = append(cmds, c)
+		}
+	}
+	if len(cmds) == 0 {
+		return "ERR Usage: BATCH <cmd> ; <cmd> ...\n"
+	}
+	if len(cmds) > c64MaxBatch {
+		return fmt.Sprintf("ERR At most %d commands\n", c64MaxBatch)
+	}
+
+	var b strings.Builder
+	fmt.Fprintf(&b, "OK %d\n", len(cmds))
+	for _, c := range cmds {
+		// Connection-level commands keep their meaning only outside a batch.
+		switch name := strings.ToUpper(strings.Fields(c)[0]); name {
+		case "BATCH", "QUIT", "FRAME":
+			fmt.Fprintf(&b, "ERR %s is not allowed in BATCH\n", name)
+			continue
+		}
+		b.WriteString(handleC64Command(c, index, apiClient, assembly64Path, conn))
+	}
+	return b.String()
+}
+
+// parseParams parses key=value arguments; keys are case-insensitive.
+func parseParams(args []string) map[string]string {
+	params := make(map[string]string)
+	for _, arg := range args {
+		if idx := strings.Index(arg, "="); idx > 0 {
+			params[strings.ToLower(arg[:idx])] = arg[idx+1:]
+		}
+	}
+	return params
+}
+
+// advancedSearchFromParams builds search criteria from ADVSEARCH/FACETS parameters.
+func advancedSearchFromParams(params map[string]string) AdvancedSearch {
+	return AdvancedSearch{
+		Category:    params["cat"],
+		Title:       params["title"],
+		Group:       params["group"],
+		FileType:    params["type"],
+		Language:    params["lang"],
+		Region:      params["region"],
+		Engine:      params["engine"],
+		Author:      params["author"],
+		SIDChips:    params["sids"],
+		Top200Only:  params["top200"] == "1",
+		MaxTrainers: -1,
+	}
+}
+
+// sortCommands are the listing commands that take a trailing sort=<key> argument.
+// ADVSEARCH takes sort as one of its key=value parameters instead.
+var sortCommands = map[string]bool{"LIST": true, "JUMP": true, "SEARCH": true}
+
+// extractSortOption removes a trailing sort=<key> argument of a listing command and
+// parses it. Other arguments, such as the words of a SEARCH query, are left alone.
+func extractSortOption(cmd string, parts []string) ([]string, sortKey, error) {
+	last := len(parts) - 1
+	if !sortCommands[cmd] || last < 1 {
+		return parts, sortNone, nil
+	}
+	arg := parts[last]
+	if len(arg) <= 5 || !strings.EqualFold(arg[:5], "sort=") {
+		return parts, sortNone, nil
+	}
+	key, ok := parseSortKey(arg[5:])
+	if !ok {
+		return nil, sortNone, fmt.Errorf("Unknown sort key: %s", arg[5:])
+	}
+	return parts[:last], key, nil
+}
+
 func handleCats(index *SearchIndex) string {
+	return index.catsResponse(func() string { return formatCats(index) })
+}
+
+// formatCats formats the CATS response.
+func formatCats(index *SearchIndex) string {
 	var b strings.Builder
 	b.WriteString(fmt.Sprintf("OK %d\n", len(index.CategoryOrder)))
 	for _, cat := range index.CategoryOrder {
@@ -193,20 +424,23 @@ func handleCats(index *SearchIndex) string {
 	return b.String()
 }
 
-func handleList(index *SearchIndex, category string, offset, count int) string {
-	// Find matching category (case-insensitive)
-	var matchedCat string
+// findCategory returns the category matching name (case-insensitive), or "".
+func findCategory(index *SearchIndex, name string) string {
 	for _, cat := range index.CategoryOrder {
-		if strings.EqualFold(cat, category) {
-			matchedCat = cat
-			break
+		if strings.EqualFold(cat, name) {
+			return cat
 		}
 	}
+	return ""
+}
+
+func handleList(index *SearchIndex, category string, offset, count int, sortBy sortKey) string {
+	matchedCat := findCategory(index, category)
 	if matchedCat == "" {
 		return fmt.Sprintf("ERR Unknown category: %s\n", category)
 	}
 
-	entries := index.ByCategory[matchedCat]
+	entries := index.sortedView(matchedCat, sortBy)
 	total := len(entries)
 
 	if offset >= total {
@@ -233,30 +467,39 @@ func handleList(index *SearchIndex, category string, offset, count int) string {
 	return b.String()
 }
 
-func handleSearch(index *SearchIndex, query string, category string, offset, count int) string {
-	query = strings.ToLower(query)
-	var results []int
+// handleJump returns "OK <offset> <total>", where offset is the LIST position of the first
+// title of the category starting with prefix in the given order.
+func handleJump(index *SearchIndex, category, prefix string, sortBy sortKey) string {
+	matchedCat := findCategory(index, category)
+	if matchedCat == "" {
+		return fmt.Sprintf("ERR Unknown category: %s\n", category)
+	}
+	if utf8.RuneCountInString(prefix) > jumpMaxPrefix {
+		return fmt.Sprintf("ERR Prefix longer than %d characters\n", jumpMaxPrefix)
+	}
 
-	// If category is specified and not "All", filter by category
-	filterByCategory := category != "" && !strings.EqualFold(category, "All")
+	offset, ok := index.jumpOffset(matchedCat, sortBy, prefix)
+	if !ok {
+		return fmt.Sprintf("ERR No titles starting with %s\n", prefix)
+	}
+	return fmt.Sprintf("OK %d %d\n", offset, len(index.sortedView(matchedCat, sortBy)))
+}
 
-	for i, entry := range index.Entries {
-		// Skip if category filter is active and doesn't match
-		if filterByCategory && !strings.EqualFold(entry.CategoryName, category) {
-			continue
-		}
-		if strings.Contains(strings.ToLower(entry.Name), query) ||
-			strings.Contains(strings.ToLower(entry.Group), query) {
-			results = append(results, i)
-		}
+// handleGroups lists the groups with entries in a category as "name|count" lines.
+func handleGroups(index *SearchIndex, category string, offset, count int) string {
+	matchedCat := findCategory(index, category)
+	if matchedCat == "" {
+		return fmt.Sprintf("ERR Unknown category: %s\n", category)
 	}
 
-	total := len(results)
+	groups := &index.browse().groups
+	counts := groups.byCategory[matchedCat]
+	total := len(counts)
 	if offset >= total {
 		return fmt.Sprintf("OK 0 %d\n.\n", total)
 	}
 
-	// If count is 0, return all results from offset
+	// If count is 0, return all groups from offset
 	end := offset + count
 	if count == 0 || end > total {
 		end = total
@@ -264,9 +507,34 @@ func handleSearch(index *SearchIndex, query string, category string, offset, cou
 
 	var b strings.Builder
 	b.WriteString(fmt.Sprintf("OK %d %d\n", end-offset, total))
+	for _, c := range counts[offset:end] {
+		b.WriteString(fmt.Sprintf("%s|%d\n", groups.names[c.name], c.count))
+	}
+	b.WriteString(".\n")
+	return b.String()
+}
 
-	for i := offset; i < end; i++ {
-		idx := results[i]
+// handleBrowseEntries lists the entries of a group or composer in LIST format.
+func handleBrowseEntries(index *SearchIndex, list *browseList, name string, offset, count int) string {
+	entries := list.lookup(name)
+	if entries == nil {
+		return fmt.Sprintf("ERR Unknown name: %s\n", name)
+	}
+
+	total := len(entries)
+	if offset >= total {
+		return fmt.Sprintf("OK 0 %d\n.\n", total)
+	}
+
+	// If count is 0, return all entries from offset
+	end := offset + count
+	if count == 0 || end > total {
+		end = total
+	}
+
+	var b strings.Builder
+	b.WriteString(fmt.Sprintf("OK %d %d\n", end-offset, total))
+	for _, idx := range entries[offset:end] {
 		entry := index.Entries[idx]
 		b.WriteString(fmt.Sprintf("%d|%s|%s|%s|%s\n",
 			idx, entry.Name, entry.Group, entry.Year, entry.FileType))
@@ -275,46 +543,43 @@ func handleSearch(index *SearchIndex, query string, category string, offset, cou
 	return b.String()
 }
 
-func handleAdvSearch(index *SearchIndex, params map[string]string, offset, count int) string {
-	var results []int
-
-	// Extract filter parameters
-	category := params["cat"]
-	title := strings.ToLower(params["title"])
-	group := strings.ToLower(params["group"])
-	fileType := strings.ToLower(params["type"])
-	top200Only := params["top200"] == "1"
-
-	for i, entry := range index.Entries {
-		// Category filter
-		if category != "" && !strings.EqualFold(category, "All") {
-			if !strings.EqualFold(entry.CategoryName, category) {
-				continue
-			}
-		}
-
-		// Title filter (partial match)
-		if title != "" && !strings.Contains(strings.ToLower(entry.Name), title) {
-			continue
-		}
+func handleSearch(index *SearchIndex, query string, category string, offset, count int, sortBy sortKey) string {
+	plan := compileSearch(index, AdvancedSearch{Category: category, Query: query, MaxTrainers: -1})
+	results := plan.run(index)
+	if sortBy == sortNone {
+		results = plan.rank(index, results)
+	} else {
+		results = index.sortResults(results, sortBy)
+	}
 
-		// Group filter (partial match)
-		if group != "" && !strings.Contains(strings.ToLower(entry.Group), group) {
-			continue
-		}
+	total := len(results)
+	if offset >= total {
+		return fmt.Sprintf("OK 0 %d\n.\n", total)
+	}
 
-		// File type filter (exact match)
-		if fileType != "" && !strings.EqualFold(entry.FileType, fileType) {
-			continue
-		}
+	// If count is 0, return all results from offset
+	end := offset + count
+	if count == 0 || end > total {
+		end = total
+	}
 
-		// Top200 filter
-		if top200Only && entry.Top200Rank == 0 {
-			continue
-		}
+	var b strings.Builder
+	b.WriteString(fmt.Sprintf("OK %d %d\n", end-offset, total))
 
-		results = append(results, i)
+	for i := offset; i < end; i++ {
+		idx := results[i]
+		entry := index.Entries[idx]
+		b.WriteString(fmt.Sprintf("%d|%s|%s|%s|%s\n",
+			idx, entry.Name, entry.Group, entry.Year, entry.FileType))
 	}
+	b.WriteString(".\n")
+	return b.String()
+}
+
+func handleAdvSearch(index *SearchIndex, params map[string]string, offset, count int, sortBy sortKey) string {
+	// Compile filter parameters into a query plan.
+	results := compileSearch(index, advancedSearchFromParams(params)).run(index)
+	results = index.sortResults(results, sortBy)
 
 	total := len(results)
 	if offset >= total {
@@ -340,11 +605,47 @@ func handleAdvSearch(index *SearchIndex, params map[string]string, offset, count
 	return b.String()
 }
 
+// handleFacets returns per-value match counts for the facet fields under the given filters.
+func handleFacets(index *SearchIndex, params map[string]string) string {
+	counts := countFacets(index, advancedSearchFromParams(params))
+
+	lines := 0
+	for _, values := range counts.Fields {
+		lines += len(values)
+	}
+
+	var b strings.Builder
+	b.WriteString(fmt.Sprintf("OK %d %d\n", lines, counts.Total))
+	for field, values := range counts.Fields {
+		for _, vc := range values {
+			// Format: field|value|count
+			b.WriteString(fmt.Sprintf("%s|%s|%d\n", facetFieldNames[field], vc.Value, vc.Count))
+		}
+	}
+	b.WriteString(".\n")
+	return b.String()
+}
+
 func handleInfo(index *SearchIndex, id int) string {
 	if id < 0 || id >= len(index.Entries) {
 		return "ERR Invalid ID\n"
 	}
+	return index.infoResponse(id, func() string { return formatInfo(index, id) })
+}
+
+// handleMultiInfo returns "OK <n>" followed by the INFO response of each id, in order.
+// Invalid IDs yield a single ERR line in their place.
+func handleMultiInfo(index *SearchIndex, ids []int) string {
+	var b strings.Builder
+	fmt.Fprintf(&b, "OK %d\n", len(ids))
+	for _, id := range ids {
+		b.WriteString(handleInfo(index, id))
+	}
+	return b.String()
+}
 
+// formatInfo formats the INFO response of a valid entry id.
+func formatInfo(index *SearchIndex, id int) string {
 	entry := index.Entries[id]
 	var b strings.Builder
 	b.WriteString("OK\n")
@@ -353,7 +654,34 @@ func handleInfo(index *SearchIndex, id int) string {
 	b.WriteString(fmt.Sprintf("YEAR|%s\n", entry.Year))
 	b.WriteString(fmt.Sprintf("CAT|%s\n", entry.CategoryName))
 	b.WriteString(fmt.Sprintf("TYPE|%s\n", entry.FileType))
-	b.WriteString(fmt.Sprintf("PATH|%s\n", entry.Path))
+	b.WriteString(fmt.Sprintf("PATH|%s\n", index.relPath(&entry)))
+
+	// Music: composer and SID header.
+	if entry.Author != "" {
+		b.WriteString(fmt.Sprintf("AUTHOR|%s\n", entry.Author))
+	}
+	if sid := entry.SID; sid != nil {
+		b.WriteString(fmt.Sprintf("RELEASED|%s\n", sid.Released))
+		b.WriteString(fmt.Sprintf("SONGS|%d/%d\n", sid.StartSong, sid.Songs))
+		b.WriteString(fmt.Sprintf("SIDS|%d\n", sid.Chips))
+		if sid.Model != "" {
+			b.WriteString(fmt.Sprintf("MODEL|%s\n", sid.Model))
+		}
+		if sid.Clock != "" {
+			b.WriteString(fmt.Sprintf("CLOCK|%s\n", sid.Clock))
+		}
+	}
+
+	// Disk images indexed by dbgen.
+	if d := entry.Disk; d != nil {
+		if d.Error == "" {
+			b.WriteString(fmt.Sprintf("DISK|%s,%s\n", d.Name, d.ID))
+			b.WriteString(fmt.Sprintf("FIRSTPRG|%s\n", d.Files[*d.FirstPRG].Name))
+		}
+		if reason := d.fileError(firstPRGFile); reason != "" {
+			b.WriteString(fmt.Sprintf("BROKEN|%s\n", reason))
+		}
+	}
 
 	// Games-specific: trainer info
 	if strings.EqualFold(entry.CategoryName, "Games") {
@@ -368,15 +696,41 @@ func handleInfo(index *SearchIndex, id int) string {
 	return b.String()
 }
 
-func handleRun(index *SearchIndex, apiClient *APIClient, assembly64Path string, id int) string {
+func handleDir(index *SearchIndex, id int) string {
+	if id < 0 || id >= len(index.Entries) {
+		return "ERR Invalid ID\n"
+	}
+
+	dir, err := index.diskDirectory(id)
+	if err != nil {
+		slog.Error("Failed to read disk directory", "id", id, "error", err)
+		return fmt.Sprintf("ERR %s\n", err)
+	}
+
+	var b strings.Builder
+	b.WriteString(fmt.Sprintf("OK %d %d\n", len(dir.files), dir.blocksFree))
+	for i, f := range dir.files {
+		// Format: file#|name|type|blocks
+		b.WriteString(fmt.Sprintf("%d|%s|%s|%d\n", i, f.filename, f.listingType(), f.blocks))
+	}
+	b.WriteString(".\n")
+	return b.String()
+}
+
+func handleRun(index *SearchIndex, apiClient *APIClient, assembly64Path string, id, file int) string {
 	if id < 0 || id >= len(index.Entries) {
 		return "ERR Invalid ID\n"
 	}
 
 	entry := index.Entries[id]
+	if file != firstPRGFile && !isDiskImageType(entry.FileType) {
+		return "ERR Not a disk image\n"
+	}
+	if err := entry.diskError(file); err != nil {
+		return fmt.Sprintf("ERR %s\n", err)
+	}
 
-	// Use FullPath which was computed during indexing
-	fullPath := entry.FullPath
+	fullPath := index.fullPath(&entry)
 	if fullPath == "" {
 		return "ERR Entry has no file path\n"
 	}
@@ -397,8 +751,8 @@ func handleRun(index *SearchIndex, apiClient *APIClient, assembly64Path string,
 		runErr = apiClient.runCRT(fileData)
 	case "sid":
 		runErr = apiClient.runSID(fileData)
-	case "d64", "g64", "d71", "d81":
-		runErr = apiClient.runDiskImage(fileData, entry.FileType, entry.Name)
+	case "d64", "g64", "d71", "d81", "g71":
+		runErr = apiClient.runDiskFile(fileData, entry.FileType, entry.Name, entry.prgLocation(file))
 	default:
 		return fmt.Sprintf("ERR Unsupported file type: %s\n", entry.FileType)
 	}
@@ -0,0 +1,171 @@
+// SID file header indexing for the music database.
+// PSID/RSID headers are read in parallel during dbgen, so composer, release and chip
+// requirements come from the tunes themselves rather than from folder names.
+package main
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync/atomic"
+	"time"
+)
+
+// SID header layout.
+const (
+	sidHeaderV1Size = 0x76 // Version 1 header, up to and including the released string.
+	sidHeaderSize   = 0x7C // Version 3+ header, including the second and third SID addresses.
+	sidStringSize   = 32
+)
+
+// SIDInfo holds the metadata of a PSID/RSID header.
+type SIDInfo struct {
+	Name      string `json:"name,omitempty"`
+	Author    string `json:"author,omitempty"`
+	Released  string `json:"released,omitempty"`
+	Songs     int    `json:"songs"`
+	StartSong int    `json:"startSong"`
+	Model     string `json:"model,omitempty"` // 6581, 8580 or any; empty if unknown.
+	Clock     string `json:"clock,omitempty"` // pal, ntsc or any; empty if unknown.
+	Chips     int    `json:"chips"`           // Number of SID chips the tune uses.
+	RSID      bool   `json:"rsid,omitempty"`  // Tune needs a real C64 environment.
+}
+
+// sidClockNames and sidModelNames decode the two-bit clock and model fields of the header flags.
+var (
+	sidClockNames = [4]string{"", "pal", "ntsc", "any"}
+	sidModelNames = [4]string{"", "6581", "8580", "any"}
+)
+
+// parseSIDHeader parses the header of a PSID or RSID file.
+func parseSIDHeader(data []byte) (*SIDInfo, error) {
+	if len(data) < sidHeaderV1Size {
+		return nil, fmt.Errorf("SID header too short: %d bytes", len(data))
+	}
+	magic := string(data[0:4])
+	if magic != "PSID" && magic != "RSID" {
+		return nil, fmt.Errorf("not a SID file")
+	}
+
+	info := &SIDInfo{
+		Songs:     int(binary.BigEndian.Uint16(data[0x0E:])),
+		StartSong: int(binary.BigEndian.Uint16(data[0x10:])),
+		Name:      sidString(data[0x16:]),
+		Author:    sidString(data[0x36:]),
+		Released:  sidString(data[0x56:]),
+		Chips:     1,
+		RSID:      magic == "RSID",
+	}
+
+	// Version 2 adds flags, version 3 a second and version 4 a third SID address.
+	version := binary.BigEndian.Uint16(data[0x04:])
+	if version >= 2 && len(data) >= 0x78 {
+		flags := binary.BigEndian.Uint16(data[0x76:])
+		info.Clock = sidClockNames[flags>>2&3]
+		info.Model = sidModelNames[flags>>4&3]
+	}
+	if version >= 3 && len(data) >= 0x7B && data[0x7A] != 0 {
+		info.Chips++
+	}
+	if version >= 4 && len(data) >= sidHeaderSize && data[0x7B] != 0 {
+		info.Chips++
+	}
+	return info, nil
+}
+
+// sidString decodes a zero-padded Latin-1 header string.
+func sidString(data []byte) string {
+	data = data[:sidStringSize]
+	if i := bytes.IndexByte(data, 0); i >= 0 {
+		data = data[:i]
+	}
+	// Latin-1 bytes are the code points U+0000-U+00FF.
+	runes := make([]rune, len(data))
+	for i, c := range data {
+		runes[i] = rune(c)
+	}
+	return strings.TrimSpace(string(runes))
+}
+
+// readSIDHeader reads and parses just the header of a SID file.
+func readSIDHeader(path string) (*SIDInfo, error) {
+	f, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer f.Close()
+
+	buf := make([]byte, sidHeaderSize)
+	n, err := io.ReadFull(f, buf)
+	if err != nil && err != io.ErrUnexpectedEOF {
+		return nil, err
+	}
+	return parseSIDHeader(buf[:n])
+}
+
+// sidIndexStats summarizes a SID header indexing run.
+type sidIndexStats struct {
+	Tunes   int
+	Failed  int
+	Elapsed time.Duration
+}
+
+// String formats the stats for progress output.
+func (s sidIndexStats) String() string {
+	return fmt.Sprintf("%d headers (%d unreadable) in %s", s.Tunes, s.Failed, s.Elapsed.Round(time.Millisecond))
+}
+
+// indexSIDHeaders reads the SID header of every entry whose primary file is a SID, in
+// parallel, and stores it in the entry. Entries without an author from their path
+// take the composer from the header, and entries without a year take it from the
+// released field.
+func indexSIDHeaders(basePath string, entries []DBEntry) sidIndexStats {
+	start := time.Now()
+
+	var tunes []*DBEntry
+	for i := range entries {
+		if entries[i].FileType == "sid" {
+			tunes = append(tunes, &entries[i])
+		}
+	}
+
+	var failed atomic.Int64
+	runParallel(len(tunes), func(i int) {
+		entry := tunes[i]
+		info, err := readSIDHeader(filepath.Join(basePath, entry.Path, entry.PrimaryFile))
+		if err != nil {
+			failed.Add(1)
+			return
+		}
+		entry.SID = info
+		if entry.Author == "" && info.Author != "" && info.Author != "<?>" {
+			entry.Author = info.Author
+		}
+		if entry.Year == nil {
+			if year, ok := releasedYear(info.Released); ok {
+				entry.Year = &year
+			}
+		}
+	})
+
+	return sidIndexStats{Tunes: len(tunes), Failed: int(failed.Load()), Elapsed: time.Since(start)}
+}
+
+// releasedYear extracts the year from a released field such as "1987 Firebird".
+func releasedYear(released string) (int, bool) {
+	if len(released) < 4 {
+		return 0, false
+	}
+	year := 0
+	for _, c := range released[:4] {
+		if c < '0' || c > '9' {
+			return 0, false
+		}
+		year = year*10 + int(c-'0')
+	}
+	return year, year >= 1982
+}
@@ -0,0 +1,243 @@
+// Sorted views over the SearchIndex.
+// For each sort key a permutation of all entries is computed once and memoized,
+// category views are derived from it, and filtered results are ordered by walking
+// the permutation instead of being re-sorted per request.
+package main
+
+import (
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+)
+
+// sortKey selects the order of listed entries.
+type sortKey int
+
+const (
+	sortNone     sortKey = iota // Load order.
+	sortTitle                   // Title, A-Z.
+	sortGroup                   // Group, then title.
+	sortYear                    // Release year, oldest first; unknown last.
+	sortTop200                  // Top200 rank, best first; unranked last.
+	sortRating                  // CSDB rating, highest first; unrated last.
+	sortParty                   // Party placement, best first; unplaced last.
+	sortPopular                 // Top200 rank, then rating; breaks relevance ties.
+	sortKeyCount                // Sentinel for key count.
+)
+
+// sortKeyNames maps protocol and display names to sort keys, in cycling order.
+var sortKeyNames = []string{"none", "title", "group", "year", "top200", "rating", "party", "popular"}
+
+// parseSortKey parses a sort key name (case-insensitive).
+func parseSortKey(name string) (sortKey, bool) {
+	for i, n := range sortKeyNames {
+		if strings.EqualFold(n, name) {
+			return sortKey(i), true
+		}
+	}
+	return sortNone, false
+}
+
+// String returns the name of the sort key.
+func (k sortKey) String() string {
+	return sortKeyNames[k]
+}
+
+// sortCache memoizes sort permutations and category views of one index.
+type sortCache struct {
+	mu    sync.Mutex
+	perms [sortKeyCount][]int   // Global permutation per key.
+	ranks [sortKeyCount][]int32 // Position of each entry in the global permutation.
+	views map[string][]int      // Category + key -> sorted category entries.
+	jumps map[string]*jumpTable // Category + key -> title prefix offsets, see jumpOffset().
+}
+
+// sortPermutation returns all entry indices ordered by key, computing it on first use.
+// The permutation is computed without holding sorts.mu, so building one order does not
+// block requests for the others; if two callers race, the first stored result wins.
+func (index *SearchIndex) sortPermutation(key sortKey) []int {
+	index.sorts.mu.Lock()
+	perm := index.sorts.perms[key]
+	index.sorts.mu.Unlock()
+	if perm != nil {
+		return perm
+	}
+
+	perm, ranks := index.buildSortPermutation(key)
+
+	index.sorts.mu.Lock()
+	defer index.sorts.mu.Unlock()
+	if existing := index.sorts.perms[key]; existing != nil {
+		return existing
+	}
+	index.sorts.perms[key] = perm
+	index.sorts.ranks[key] = ranks
+	return perm
+}
+
+// warmSorts computes the permutations of all sort keys, so the first sorted listing or
+// Ctrl+S does not pay for the sort. It is run in the background after loading.
+func (index *SearchIndex) warmSorts() {
+	for key := sortNone + 1; key < sortKeyCount; key++ {
+		index.sortPermutation(key)
+	}
+}
+
+// buildSortPermutation sorts all entry indices by key and returns the permutation and
+// the position of each entry in it.
+func (index *SearchIndex) buildSortPermutation(key sortKey) ([]int, []int32) {
+	perm := make([]int, len(index.Entries))
+	for i := range perm {
+		perm[i] = i
+	}
+	if key != sortNone {
+		less := index.sortLess(key)
+		sort.SliceStable(perm, func(a, b int) bool {
+			return less(perm[a], perm[b])
+		})
+	}
+
+	ranks := make([]int32, len(perm))
+	for pos, i := range perm {
+		ranks[i] = int32(pos)
+	}
+	return perm, ranks
+}
+
+// sortLess returns the ordering function for key; ties fall back to title, then load order.
+func (index *SearchIndex) sortLess(key sortKey) func(a, b int) bool {
+	entries := index.Entries
+	f := index.facets()
+
+	// Entries without a value for the key sort last.
+	byInt := func(value func(i int) int) func(a, b int) bool {
+		return func(a, b int) bool {
+			va, vb := value(a), value(b)
+			if va != vb {
+				if va == 0 || vb == 0 {
+					return vb == 0
+				}
+				return va < vb
+			}
+			return f.names[a] < f.names[b]
+		}
+	}
+
+	switch key {
+	case sortTitle:
+		return func(a, b int) bool {
+			return f.names[a] < f.names[b]
+		}
+	case sortGroup:
+		return func(a, b int) bool {
+			if f.groups[a] != f.groups[b] {
+				return f.groups[a] < f.groups[b]
+			}
+			return f.names[a] < f.names[b]
+		}
+	case sortYear:
+		// Parse the years once rather than in every comparison.
+		years := make([]int, len(entries))
+		for i := range entries {
+			years[i], _ = strconv.Atoi(entries[i].Year)
+		}
+		return byInt(func(i int) int { return years[i] })
+	case sortTop200:
+		return byInt(func(i int) int { return entries[i].Top200Rank })
+	case sortParty:
+		return byInt(func(i int) int { return entries[i].PartyRank })
+	case sortRating:
+		return func(a, b int) bool {
+			if entries[a].Rating != entries[b].Rating {
+				return entries[a].Rating > entries[b].Rating
+			}
+			return f.names[a] < f.names[b]
+		}
+	case sortPopular:
+		byRating := index.sortLess(sortRating)
+		return func(a, b int) bool {
+			ra, rb := entries[a].Top200Rank, entries[b].Top200Rank
+			if ra != rb {
+				if ra == 0 || rb == 0 {
+					return rb == 0
+				}
+				return ra < rb
+			}
+			return byRating(a, b)
+		}
+	}
+	return func(a, b int) bool { return a < b }
+}
+
+// sortedView returns the entries of a category ordered by key.
+// The result is memoized and must not be modified.
+func (index *SearchIndex) sortedView(category string, key sortKey) []int {
+	if key == sortNone {
+		return index.ByCategory[category]
+	}
+
+	perm := index.sortPermutation(key)
+
+	index.sorts.mu.Lock()
+	defer index.sorts.mu.Unlock()
+
+	viewKey := category + "\x00" + key.String()
+	if view, ok := index.sorts.views[viewKey]; ok {
+		return view
+	}
+
+	var view []int
+	if category == "All" {
+		view = perm
+	} else {
+		view = make([]int, 0, len(index.ByCategory[category]))
+		for _, i := range perm {
+			if index.Entries[i].CategoryName == category {
+				view = append(view, i)
+			}
+		}
+	}
+
+	if index.sorts.views == nil {
+		index.sorts.views = make(map[string][]int)
+	}
+	index.sorts.views[viewKey] = view
+	return view
+}
+
+// sortResults returns the given entry indices ordered by key; sortNone restores load order.
+// Small result sets are sorted by their precomputed ranks; large ones are collected
+// by walking the permutation, so no comparisons are needed either way.
+func (index *SearchIndex) sortResults(results []int, key sortKey) []int {
+	if len(results) < 2 || (key == sortNone && sort.IntsAreSorted(results)) {
+		return results
+	}
+
+	perm := index.sortPermutation(key)
+	index.sorts.mu.Lock()
+	ranks := index.sorts.ranks[key]
+	index.sorts.mu.Unlock()
+
+	sorted := make([]int, len(results))
+	if len(results) < len(perm)/16 {
+		copy(sorted, results)
+		sort.Slice(sorted, func(a, b int) bool {
+			return ranks[sorted[a]] < ranks[sorted[b]]
+		})
+		return sorted
+	}
+
+	member := make([]bool, len(perm))
+	for _, i := range results {
+		member[i] = true
+	}
+	n := 0
+	for _, i := range perm {
+		if member[i] {
+			sorted[n] = i
+			n++
+		}
+	}
+	return sorted[:n]
+}
@@ -4,10 +4,9 @@ package main
 
 import (
 	"fmt"
-	"os"
-	"path/filepath"
 	"strconv"
 	"strings"
+	"sync/atomic"
 
 	tea "github.com/charmbracelet/bubbletea"
 	"github.com/charmbracelet/lipgloss"
@@ -19,6 +18,7 @@ type searchMode int
 const (
 	modeNormal searchMode = iota
 	modeAdvanced
+	modeDirectory
 )
 
 // advancedField represents a field in the advanced search form.
@@ -28,10 +28,12 @@ const (
 	fieldCategory advancedField = iota
 	fieldTitle
 	fieldGroup
+	fieldAuthor
 	fieldLanguage
 	fieldRegion
 	fieldEngine
 	fieldFileType
+	fieldSIDChips
 	fieldMinTrainers
 	fieldMaxTrainers
 	fieldTop200Only
@@ -102,6 +104,9 @@ type Model struct {
 	apiClient        *APIClient
 	searchQuery      string
 	selectedCategory string
+	sortBy           sortKey
+	hideMirrors      bool       // Show only the first of entries with identical content.
+	group            *groupView // "More from this group" listing, nil while showing search results.
 	filteredResults  []int
 	cursor           int
 	scrollOffset     int
@@ -113,11 +118,30 @@ type Model struct {
 	assembly64Path   string
 	legacyMode       bool // True if using legacy .releaselog.json loading (enables refresh)
 
+	// Background filtering state.
+	filterGen   *atomic.Uint64 // Generation of the newest filter job, shared by all model copies.
+	filtering   bool           // True while a filter job has not delivered its final results.
+	narrowStack []narrowLevel  // Completed results per query prefix, shortest query first.
+	searchPlan  *queryPlan     // Plan of the current search, used to rank its results.
+
+	render *renderCache // Rendered rows and header, shared by all model copies.
+
+	// Launch state.
+	launches  *launchState // Launch in flight, shared by all model copies.
+	launching bool         // True until the newest launch has finished.
+
+	// Disk directory view state.
+	dirEntry  ReleaseEntry   // Disk image entry being listed.
+	dir       *diskDirectory // Its parsed directory.
+	dirCursor int
+
 	// Advanced search state.
 	mode           searchMode
 	advSearch      AdvancedSearch
 	activeField    advancedField
 	advFieldValues [fieldCount]string // Text values for text input fields.
+	facetCounts    *facetCounts       // Match counts per filter value for the form, nil until computed.
+	facetSeq       int                // Sequence number of the newest facet count request.
 }
 
 // NewModel creates a new TUI model.
@@ -132,14 +156,17 @@ func NewModel(index *SearchIndex, apiClient *APIClient, assembly64Path string, l
 		filteredResults:  make([]int, 0),
 		mode:             modeNormal,
 		advSearch:        AdvancedSearch{MaxTrainers: -1},
+		filterGen:        new(atomic.Uint64),
+		filtering:        true,
+		render:           newRenderCache(),
+		launches:         &launchState{},
 	}
-	m.applyFilters()
 	return m
 }
 
-// Init initializes the model.
+// Init initializes the model and starts the initial filter run.
 func (m Model) Init() tea.Cmd {
-	return nil
+	return m.applyFilters()
 }
 
 // handleNavigation handles cursor navigation keys.
@@ -174,7 +201,17 @@ func (m *Model) handleNavigation(key string) {
 func (m Model) handleKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 	// Handle mode-specific keys.
 	if m.mode == modeAdvanced {
-		return m.handleAdvancedKeyMsg(msg)
+		before := m.formSearch()
+		m, cmd := m.handleAdvancedKeyMsg(msg)
+		// Recount the filter options whenever the form changes.
+		if m.mode == modeAdvanced && m.formSearch() != before {
+			facets := m.requestFacets()
+			return m, tea.Batch(cmd, facets)
+		}
+		return m, cmd
+	}
+	if m.mode == modeDirectory {
+		return m.handleDirectoryKeyMsg(msg)
 	}
 	return m.handleNormalKeyMsg(msg)
 }
@@ -187,13 +224,21 @@ func (m Model) handleNormalKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 		return m, tea.Quit
 
 	case "esc":
-		// Clear search query, or quit if empty.
+		// Cancel a launch in flight, clear search query, or quit if empty.
+		if m.launching && m.launches.cancelCurrent() {
+			m.statusMessage = "Cancelling..."
+			return m, nil
+		}
+		if m.group != nil {
+			cmd := m.closeGroup()
+			return m, cmd
+		}
 		if m.searchQuery != "" {
 			m.searchQuery = ""
 			m.cursor = 0
 			m.scrollOffset = 0
-			m.applyFilters()
-			return m, nil
+			cmd := m.applyFilters()
+			return m, cmd
 		}
 		m.quitting = true
 		return m, tea.Quit
@@ -211,6 +256,8 @@ func (m Model) handleNormalKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 			} else {
 				m.advSearch.Category = m.selectedCategory
 			}
+			cmd := m.requestFacets()
+			return m, cmd
 		}
 		return m, nil
 
@@ -225,8 +272,44 @@ func (m Model) handleNormalKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 		m.advFieldValues = [fieldCount]string{}
 		m.cursor = 0
 		m.scrollOffset = 0
-		m.applyFilters()
 		m.statusMessage = "Search reset"
+		cmd := m.applyFilters()
+		return m, cmd
+
+	case "ctrl+s":
+		// Cycle through sort keys; running filters apply the order when they complete.
+		m.sortBy = (m.sortBy + 1) % sortKeyCount
+		if m.group != nil {
+			m.showGroup()
+		} else if !m.filtering {
+			m.filteredResults = m.orderResults(m.filteredResults)
+		}
+		m.cursor = 0
+		m.scrollOffset = 0
+		return m, nil
+
+	case "ctrl+u":
+		// Toggle hiding mirrors; the filter reruns since the shown results are collapsed.
+		if m.legacyMode || m.searchPlan == nil {
+			return m, nil
+		}
+		m.hideMirrors = !m.hideMirrors
+		m.statusMessage = "Showing mirrors"
+		if m.hideMirrors {
+			m.statusMessage = "Hiding mirrors"
+		}
+		if m.group != nil {
+			m.showGroup()
+			return m, nil
+		}
+		m.cursor = 0
+		m.scrollOffset = 0
+		cmd := m.startFilter(m.searchPlan.candidates, m.searchPlan.matches, nil)
+		return m, cmd
+
+	case "ctrl+g":
+		// List more entries from the selected entry's group.
+		m.openGroup()
 		return m, nil
 
 	case "tab":
@@ -242,22 +325,28 @@ func (m Model) handleNormalKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 		m.selectedCategory = m.index.CategoryOrder[nextIdx]
 		m.cursor = 0
 		m.scrollOffset = 0
-		m.applyFilters()
-		return m, nil
+		cmd := m.applyFilters()
+		return m, cmd
 
 	case "up", "down", "pgup", "pgdown", "home", "end":
 		m.handleNavigation(msg.String())
 		return m, nil
 
 	case "enter":
-		return m, m.loadSelectedEntry()
+		cmd := m.loadSelectedEntry()
+		return m, cmd
+
+	case "ctrl+d":
+		// List the files of the selected disk image.
+		return m, m.openDirectory()
 
 	case "backspace":
 		if len(m.searchQuery) > 0 {
 			m.searchQuery = m.searchQuery[:len(m.searchQuery)-1]
 			m.cursor = 0
 			m.scrollOffset = 0
-			m.applyFilters()
+			cmd := m.applyFilters()
+			return m, cmd
 		}
 		return m, nil
 
@@ -267,7 +356,8 @@ func (m Model) handleNormalKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 			m.searchQuery += msg.String()
 			m.cursor = 0
 			m.scrollOffset = 0
-			m.applyFilters()
+			cmd := m.applyFilters()
+			return m, cmd
 		}
 		return m, nil
 	}
@@ -287,11 +377,11 @@ func (m Model) handleAdvancedKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 
 	case "enter":
 		// Apply advanced search and return to results.
-		m.applyAdvancedSearch()
+		cmd := m.applyAdvancedSearch()
 		m.mode = modeNormal
 		m.cursor = 0
 		m.scrollOffset = 0
-		return m, nil
+		return m, cmd
 
 	case "up":
 		if m.activeField > 0 {
@@ -345,8 +435,8 @@ func (m Model) handleAdvancedKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
 // isTextField returns true if the field accepts text input.
 func (m *Model) isTextField(field advancedField) bool {
 	switch field {
-	case fieldTitle, fieldGroup, fieldLanguage, fieldRegion, fieldEngine, fieldFileType,
-		fieldMinTrainers, fieldMaxTrainers:
+	case fieldTitle, fieldGroup, fieldAuthor, fieldLanguage, fieldRegion, fieldEngine, fieldFileType,
+		fieldSIDChips, fieldMinTrainers, fieldMaxTrainers:
 		return true
 	}
 	return false
@@ -400,30 +490,94 @@ func (m *Model) toggleField(field advancedField) {
 	}
 }
 
-// applyAdvancedSearch transfers form values to AdvancedSearch struct.
-func (m *Model) applyAdvancedSearch() {
-	m.advSearch.Title = m.advFieldValues[fieldTitle]
-	m.advSearch.Group = m.advFieldValues[fieldGroup]
-	m.advSearch.Language = m.advFieldValues[fieldLanguage]
-	m.advSearch.Region = m.advFieldValues[fieldRegion]
-	m.advSearch.Engine = m.advFieldValues[fieldEngine]
-	m.advSearch.FileType = m.advFieldValues[fieldFileType]
+// applyAdvancedSearch transfers form values to AdvancedSearch struct and starts filtering.
+func (m *Model) applyAdvancedSearch() tea.Cmd {
+	m.advSearch = m.formSearch()
+	return m.applyAdvancedFilters()
+}
+
+// formSearch returns the search criteria currently entered in the advanced search form.
+func (m *Model) formSearch() AdvancedSearch {
+	as := m.advSearch
+	as.Title = m.advFieldValues[fieldTitle]
+	as.Group = m.advFieldValues[fieldGroup]
+	as.Language = m.advFieldValues[fieldLanguage]
+	as.Region = m.advFieldValues[fieldRegion]
+	as.Engine = m.advFieldValues[fieldEngine]
+	as.FileType = m.advFieldValues[fieldFileType]
+	as.Author = m.advFieldValues[fieldAuthor]
+	as.SIDChips = m.advFieldValues[fieldSIDChips]
 
 	// Parse trainer counts.
-	m.advSearch.MinTrainers = 0
-	m.advSearch.MaxTrainers = -1
+	as.MinTrainers = 0
+	as.MaxTrainers = -1
 	if val := m.advFieldValues[fieldMinTrainers]; val != "" {
 		if n, err := strconv.Atoi(val); err == nil {
-			m.advSearch.MinTrainers = n
+			as.MinTrainers = n
 		}
 	}
 	if val := m.advFieldValues[fieldMaxTrainers]; val != "" {
 		if n, err := strconv.Atoi(val); err == nil {
-			m.advSearch.MaxTrainers = n
+			as.MaxTrainers = n
 		}
 	}
 
-	m.applyAdvancedFilters()
+	return as
+}
+
+// requestFacets returns a command that counts the matches per filter value for the
+// current form contents in the background.
+func (m *Model) requestFacets() tea.Cmd {
+	m.facetSeq++
+	seq, index, as := m.facetSeq, m.index, m.formSearch()
+	return func() tea.Msg {
+		return facetCountsMsg{seq: seq, counts: countFacets(index, as)}
+	}
+}
+
+// facetFieldOf returns the facet field shown by a form field.
+func facetFieldOf(field advancedField) (facetField, bool) {
+	switch field {
+	case fieldFileType:
+		return facetFileType, true
+	case fieldLanguage:
+		return facetLanguage, true
+	case fieldRegion:
+		return facetRegion, true
+	case fieldEngine:
+		return facetEngine, true
+	case fieldTop200Only:
+		return facetTop200, true
+	case fieldSIDChips:
+		return facetSIDChips, true
+	}
+	return 0, false
+}
+
+// renderFacetHint renders the match counts of a form field: the count of the entered
+// value, or the most common values while the field is empty.
+func (m Model) renderFacetHint(field advancedField) string {
+	ff, ok := facetFieldOf(field)
+	if !ok || m.facetCounts == nil {
+		return ""
+	}
+
+	if field == fieldTop200Only {
+		return dimStyle.Render(fmt.Sprintf(" (%d)", m.facetCounts.count(ff, "1")))
+	}
+	if val := m.advFieldValues[field]; val != "" {
+		return dimStyle.Render(fmt.Sprintf(" (%d)", m.facetCounts.count(ff, val)))
+	}
+
+	values := m.facetCounts.Fields[ff]
+	if len(values) == 0 {
+		return ""
+	}
+	var parts []string
+	for _, vc := range values[:min(len(values), 4)] {
+		parts = append(parts, fmt.Sprintf("%s %d", vc.Value, vc.Count))
+	}
+	return dimStyle.Render(" " + strings.Join(parts, ", "))
 }
 
 // Update handles messages and updates the model.
@@ -449,14 +603,32 @@ func (m Model) Update(msg tea.Msg) (tea.Model, tea.Cmd) {
 			m.err = msg.err
 			m.statusMessage = ""
 		} else {
-			// Replace the index with the refreshed one.
+			// Replace the index with the refreshed one and drop results cached for the old one.
 			m.index = msg.index
+			m.narrowStack = nil
 			m.statusMessage = "✓ Index refreshed"
 			m.err = nil
 			// Re-apply filters to update the display.
 			m.cursor = 0
 			m.scrollOffset = 0
-			m.applyFilters()
+			cmd := m.applyFilters()
+			return m, cmd
+		}
+		return m, nil
+
+	case filterResultMsg:
+		return m.handleFilterResult(msg)
+
+	case launchMsg:
+		return m.handleLaunchMsg(msg)
+
+	case dirMsg:
+		return m.handleDirMsg(msg)
+
+	case facetCountsMsg:
+		// Ignore counts for form contents that have changed since.
+		if msg.seq == m.facetSeq {
+			m.facetCounts = msg.counts
 		}
 		return m, nil
 
@@ -468,7 +640,20 @@ func (m Model) Update(msg tea.Msg) (tea.Model, tea.Cmd) {
 }
 
 // renderHeader renders the title, category selector, and search input.
+// The result is cached until one of its inputs changes.
 func (m Model) renderHeader() string {
+	key := headerKey{
+		index:    m.index,
+		category: m.selectedCategory,
+		query:    m.searchQuery,
+		sortBy:   m.sortBy,
+		width:    m.width,
+	}
+	return m.render.cachedHeader(key, m.buildHeader)
+}
+
+// buildHeader builds the header rendered by renderHeader.
+func (m Model) buildHeader() string {
 	var b strings.Builder
 
 	// Title.
@@ -489,6 +674,20 @@ func (m Model) renderHeader() string {
 	}
 	b.WriteString("\n")
 
+	// Sort selector.
+	b.WriteString(headerStyle.Render("Sort:     "))
+	for k := sortNone; k < sortKeyCount; k++ {
+		if k == m.sortBy {
+			b.WriteString(selectedStyle.Render("[" + k.String() + "]"))
+		} else {
+			b.WriteString(categoryStyle.Render(k.String()))
+		}
+		if k < sortKeyCount-1 {
+			b.WriteString(" ")
+		}
+	}
+	b.WriteString("\n")
+
 	// Search input.
 	b.WriteString(headerStyle.Render("Search: "))
 	if m.searchQuery == "" {
@@ -506,7 +705,10 @@ func (m Model) renderHeader() string {
 func (m Model) renderResults(viewHeight int) string {
 	var b strings.Builder
 
-	if len(m.filteredResults) == 0 {
+	if len(m.filteredResults) == 0 && m.filtering {
+		b.WriteString(dimStyle.Render("Searching..."))
+		b.WriteString("\n")
+	} else if len(m.filteredResults) == 0 {
 		b.WriteString(dimStyle.Render("No results found"))
 		b.WriteString("\n")
 	} else {
@@ -515,15 +717,17 @@ func (m Model) renderResults(viewHeight int) string {
 		end := min(start+viewHeight, len(m.filteredResults))
 
 		for i := start; i < end; i++ {
-			entry := m.index.Entries[m.filteredResults[i]]
-			line := m.formatEntry(entry, i == m.cursor)
-			b.WriteString(line)
+			b.WriteString(m.render.row(&m, m.filteredResults[i], i == m.cursor))
 			b.WriteString("\n")
 		}
 
 		// Result count.
 		b.WriteString("\n")
-		b.WriteString(dimStyle.Render(fmt.Sprintf("[%d results]", len(m.filteredResults))))
+		if m.filtering {
+			b.WriteString(dimStyle.Render(fmt.Sprintf("[%d+ results, searching...]", len(m.filteredResults))))
+		} else {
+			b.WriteString(dimStyle.Render(fmt.Sprintf("[%d results]", len(m.filteredResults))))
+		}
 		b.WriteString("\n")
 	}
 
@@ -546,17 +750,16 @@ func (m Model) renderFooter() string {
 	// Help text.
 	var helpText string
 	if m.legacyMode {
-		helpText = "↑/↓: Navigate  Tab: Category  Enter: Load  Ctrl+L: Refresh  Esc/Q: Quit"
+		helpText = "↑/↓: Navigate  Tab: Category  Ctrl+S: Sort  Enter: Load  Ctrl+D: Files  Ctrl+G: Group  Ctrl+L: Refresh  Esc/Q: Quit"
 	} else {
-		helpText = "↑/↓: Navigate  Tab: Category  /: Advanced  Enter: Load  Ctrl+L: Reset  Esc/Q: Quit"
+		helpText = "↑/↓: Navigate  Tab: Category  Ctrl+S: Sort  /: Advanced  Enter: Load  Ctrl+D: Files  Ctrl+G: Group  Ctrl+U: Mirrors  Ctrl+L: Reset  Esc/Q: Quit"
 	}
 	b.WriteString(helpStyle.Render(helpText))
 	b.WriteString("\n")
 
 	// Selected file path.
 	if len(m.filteredResults) > 0 && m.cursor < len(m.filteredResults) {
-		entry := m.index.Entries[m.filteredResults[m.cursor]]
-		path := entry.FullPath
+		path := m.index.fullPath(&m.index.Entries[m.filteredResults[m.cursor]])
 		if m.width > 10 && len(path) > m.width-2 {
 			truncLen := m.width - 5
 			if truncLen > 0 && truncLen < len(path) {
@@ -579,6 +782,9 @@ func (m Model) View() string {
 	if m.mode == modeAdvanced {
 		return m.renderAdvancedSearchForm()
 	}
+	if m.mode == modeDirectory {
+		return m.renderDirectory()
+	}
 
 	var b strings.Builder
 
@@ -586,7 +792,7 @@ func (m Model) View() string {
 	b.WriteString(m.renderHeader())
 
 	// Calculate view height.
-	viewHeight := m.height - 12 // Reserve space for header/footer.
+	viewHeight := m.height - 13 // Reserve space for header/footer.
 	if viewHeight < 5 {
 		viewHeight = 5
 	}
@@ -616,10 +822,12 @@ func (m Model) renderAdvancedSearchForm() string {
 		{fieldCategory, "Category", "All/Games/Demos/Music"},
 		{fieldTitle, "Title", "partial match"},
 		{fieldGroup, "Group", "partial match"},
+		{fieldAuthor, "Composer", "partial match (music)"},
 		{fieldLanguage, "Language", "german, french, english..."},
 		{fieldRegion, "Region", "PAL, NTSC"},
 		{fieldEngine, "Engine", "seuck, gkgm, bdck..."},
 		{fieldFileType, "File Type", "d64, prg, crt..."},
+		{fieldSIDChips, "SID Chips", "1, 2, 3 (music)"},
 		{fieldMinTrainers, "Min Trainers", "number"},
 		{fieldMaxTrainers, "Max Trainers", "number (-1 = any)"},
 		{fieldTop200Only, "Top 200 Only", "toggle"},
@@ -654,7 +862,13 @@ func (m Model) renderAdvancedSearchForm() string {
 			cursor = "> "
 		}
 
-		b.WriteString(cursor + label + " " + value + "\n")
+		b.WriteString(cursor + label + " " + value + m.renderFacetHint(f.field) + "\n")
+	}
+
+	if m.facetCounts != nil {
+		b.WriteString("\n")
+		b.WriteString(headerStyle.Render(fmt.Sprintf("Matches: %d", m.facetCounts.Total)))
+		b.WriteString("\n")
 	}
 
 	b.WriteString("\n")
@@ -747,12 +961,20 @@ func (m Model) formatEntry(entry ReleaseEntry, selected bool) string {
 
 	// Format group/year.
 	meta := ""
-	if entry.Group != "" || entry.Year != "" {
-		meta = fmt.Sprintf("(%s, %s)", entry.Group, entry.Year)
+	group := entry.Group
+	if group == "" {
+		// Music has a composer instead of a group.
+		group = entry.Author
+	}
+	if group != "" || entry.Year != "" {
+		meta = fmt.Sprintf("(%s, %s)", group, entry.Year)
 	}
 
 	// Format extension.
 	ext := "." + entry.FileType
+	if entry.diskError(firstPRGFile) != nil {
+		ext += " (broken)"
+	}
 
 	line := fmt.Sprintf("%s%-32s  %-25s  %s", cursor, name, meta, ext)
 
@@ -762,152 +984,23 @@ func (m Model) formatEntry(entry ReleaseEntry, selected bool) string {
 	return line
 }
 
-// applyFilters filters entries based on category and search query.
-func (m *Model) applyFilters() {
-	m.filteredResults = make([]int, 0)
+// applyFilters starts filtering entries based on category and search query.
+func (m *Model) applyFilters() tea.Cmd {
 	query := strings.ToLower(m.searchQuery)
-
-	for i, entry := range m.index.Entries {
-		// Category filter.
-		if m.selectedCategory != "All" && entry.CategoryName != m.selectedCategory {
-			continue
-		}
-
-		// Search filter.
-		if query != "" {
-			nameMatch := strings.Contains(strings.ToLower(entry.Name), query)
-			groupMatch := strings.Contains(strings.ToLower(entry.Group), query)
-			if !nameMatch && !groupMatch {
-				continue
-			}
-		}
-
-		m.filteredResults = append(m.filteredResults, i)
-	}
-
-	// Reset cursor if out of bounds.
-	if m.cursor >= len(m.filteredResults) {
-		m.cursor = 0
-		m.scrollOffset = 0
-	}
+	category := m.selectedCategory
+	m.group = nil
+	return m.startSearch(category, query)
 }
 
-// applyAdvancedFilters filters entries based on AdvancedSearch criteria.
-func (m *Model) applyAdvancedFilters() {
-	m.filteredResults = make([]int, 0)
-	as := m.advSearch
-
-	for i, entry := range m.index.Entries {
-		// Category filter from advanced search.
-		if as.Category != "" && entry.CategoryName != as.Category {
-			continue
-		}
-
-		// Title filter.
-		if as.Title != "" && !strings.Contains(strings.ToLower(entry.Name), strings.ToLower(as.Title)) {
-			continue
-		}
-
-		// Group filter.
-		if as.Group != "" && !strings.Contains(strings.ToLower(entry.Group), strings.ToLower(as.Group)) {
-			continue
-		}
-
-		// Language filter (exact match).
-		if as.Language != "" && !strings.EqualFold(entry.Language, as.Language) {
-			continue
-		}
-
-		// Region filter (exact match).
-		if as.Region != "" && !strings.EqualFold(entry.Region, as.Region) {
-			continue
-		}
-
-		// Engine filter (exact match).
-		if as.Engine != "" && !strings.EqualFold(entry.Engine, as.Engine) {
-			continue
-		}
-
-		// File type filter (exact match).
-		if as.FileType != "" && !strings.EqualFold(entry.FileType, as.FileType) {
-			continue
-		}
-
-		// Top200 filter.
-		if as.Top200Only && entry.Top200Rank == 0 {
-			continue
-		}
-
-		// 4k filter.
-		if as.Is4kOnly && !entry.Is4k {
-			continue
-		}
-
-		// Crack-related filters.
-		if as.IsCracked != nil {
-			isCracked := entry.Crack != nil && entry.Crack.IsCracked
-			if *as.IsCracked != isCracked {
-				continue
-			}
-		}
-
-		// Trainer count filters.
-		if as.MinTrainers > 0 || as.MaxTrainers >= 0 || as.HasDocs || as.HasFastload {
-			if entry.Crack == nil {
-				continue
-			}
-
-			trainers := entry.Crack.Trainers
-
-			if as.MinTrainers > 0 && trainers < as.MinTrainers {
-				continue
-			}
-			if as.MaxTrainers >= 0 && trainers > as.MaxTrainers {
-				continue
-			}
-
-			// Docs filter.
-			if as.HasDocs {
-				hasDocs := false
-				for _, flag := range entry.Crack.Flags {
-					if flag == "docs" {
-						hasDocs = true
-						break
-					}
-				}
-				if !hasDocs {
-					continue
-				}
-			}
-
-			// Fastload filter.
-			if as.HasFastload {
-				hasFastload := false
-				for _, flag := range entry.Crack.Flags {
-					if flag == "fastload" {
-						hasFastload = true
-						break
-					}
-				}
-				if !hasFastload {
-					continue
-				}
-			}
-		}
-
-		m.filteredResults = append(m.filteredResults, i)
-	}
-
-	// Reset cursor if out of bounds.
-	if m.cursor >= len(m.filteredResults) {
-		m.cursor = 0
-		m.scrollOffset = 0
-	}
+// applyAdvancedFilters starts filtering entries based on AdvancedSearch criteria.
+func (m *Model) applyAdvancedFilters() tea.Cmd {
+	m.group = nil
+	return m.startCompiled(m.advSearch, nil, nil)
 }
 
 // adjustScroll adjusts scroll offset to keep cursor visible.
 func (m *Model) adjustScroll() {
-	viewHeight := m.height - 12
+	viewHeight := m.height - 13
 	if viewHeight < 5 {
 		viewHeight = 5
 	}
@@ -926,56 +1019,23 @@ func (m *Model) refreshIndex() tea.Cmd {
 		if err != nil {
 			return refreshMsg{err: fmt.Errorf("failed to refresh index: %w", err)}
 		}
+		index.warmCaches()
 		return refreshMsg{index: index}
 	}
 }
 
-// loadSelectedEntry loads the selected entry to C64 Ultimate.
-func (m *Model) loadSelectedEntry() tea.Cmd {
-	return func() tea.Msg {
-		if len(m.filteredResults) == 0 {
-			return statusMsg{err: fmt.Errorf("no entry selected")}
-		}
-
-		entry := m.index.Entries[m.filteredResults[m.cursor]]
-
-		// Read file.
-		data, err := os.ReadFile(entry.FullPath)
-		if err != nil {
-			return statusMsg{err: fmt.Errorf("failed to read file: %w", err)}
-		}
-
-		// Call appropriate API based on file type.
-		var loadErr error
-		switch entry.FileType {
-		case "d64", "d71", "d81", "g64", "g71":
-			// Use existing runDiskImage (auto-runs first PRG).
-			loadErr = m.apiClient.runDiskImage(data, entry.FileType, filepath.Base(entry.FullPath))
-		case "prg":
-			loadErr = m.apiClient.runPRG(data)
-		case "crt":
-			loadErr = m.apiClient.runCRT(data)
-		case "sid":
-			// SID files are handled like PRG files on C64 Ultimate.
-			loadErr = m.apiClient.runSID(data)
-		default:
-			return statusMsg{err: fmt.Errorf("unsupported file type: %s", entry.FileType)}
-		}
-
-		if loadErr != nil {
-			return statusMsg{err: fmt.Errorf("failed to load: %w", loadErr)}
-		}
-
-		return statusMsg{message: fmt.Sprintf("✓ Loaded: %s", entry.Name)}
-	}
-}
-
 // statusMsg is a message for status updates.
 type statusMsg struct {
 	message string
 	err     error
 }
 
+// facetCountsMsg carries facet counts computed for the advanced search form.
+type facetCountsMsg struct {
+	seq    int
+	counts *facetCounts
+}
+
 // refreshMsg is a message for index refresh results.
 type refreshMsg struct {
 	index *SearchIndex
@@ -0,0 +1,139 @@
+// Disk directory view of the terminal user interface.
+// Ctrl+D lists the files of the selected disk image, and Enter runs the chosen PRG
+// instead of the first one on the disk.
+package main
+
+import (
+	"fmt"
+	"strings"
+
+	tea "github.com/charmbracelet/bubbletea"
+)
+
+// dirMsg delivers the parsed directory of a disk image entry.
+type dirMsg struct {
+	entry ReleaseEntry
+	dir   *diskDirectory
+	err   error
+}
+
+// openDirectory returns a command that loads the directory of the selected entry.
+func (m Model) openDirectory() tea.Cmd {
+	if len(m.filteredResults) == 0 {
+		return nil
+	}
+	id := m.filteredResults[m.cursor]
+	index := m.index
+	return func() tea.Msg {
+		dir, err := index.diskDirectory(id)
+		return dirMsg{entry: index.Entries[id], dir: dir, err: err}
+	}
+}
+
+// handleDirMsg shows a loaded directory.
+func (m Model) handleDirMsg(msg dirMsg) (Model, tea.Cmd) {
+	if msg.err != nil {
+		m.err = fmt.Errorf("failed to read directory: %w", msg.err)
+		m.statusMessage = ""
+		return m, nil
+	}
+	m.mode = modeDirectory
+	m.dirEntry = msg.entry
+	m.dir = msg.dir
+	m.dirCursor = 0
+	// Start on the file a plain Enter would run.
+	for i, f := range msg.dir.files {
+		if f.fileType == fileTypePRG {
+			m.dirCursor = i
+			break
+		}
+	}
+	m.err = nil
+	m.statusMessage = ""
+	return m, nil
+}
+
+// handleDirectoryKeyMsg handles keys in the disk directory view.
+func (m Model) handleDirectoryKeyMsg(msg tea.KeyMsg) (Model, tea.Cmd) {
+	switch msg.String() {
+	case "ctrl+c":
+		m.quitting = true
+		return m, tea.Quit
+
+	case "esc":
+		// Cancel a launch in flight, or return to the results.
+		if m.launching && m.launches.cancelCurrent() {
+			m.statusMessage = "Cancelling..."
+			return m, nil
+		}
+		m.mode = modeNormal
+		return m, nil
+
+	case "up":
+		if m.dirCursor > 0 {
+			m.dirCursor--
+		}
+	case "down":
+		if m.dirCursor < len(m.dir.files)-1 {
+			m.dirCursor++
+		}
+	case "home":
+		m.dirCursor = 0
+	case "end":
+		m.dirCursor = max(len(m.dir.files)-1, 0)
+
+	case "enter":
+		if len(m.dir.files) == 0 {
+			return m, nil
+		}
+		if f := m.dir.files[m.dirCursor]; f.fileType != fileTypePRG {
+			m.err = fmt.Errorf("%s is not a PRG file", f.filename)
+			return m, nil
+		}
+		cmd := m.startLaunch(m.dirEntry, m.dirCursor)
+		return m, cmd
+	}
+	return m, nil
+}
+
+// renderDirectory renders the disk directory view.
+func (m Model) renderDirectory() string {
+	var b strings.Builder
+
+	b.WriteString(titleStyle.Render(m.dirEntry.Name))
+	b.WriteString("\n\n")
+	b.WriteString(headerStyle.Render(fmt.Sprintf("0 \"%-16s\" %s  (%s)", m.dir.name, m.dir.id, strings.ToUpper(m.dir.format))))
+	b.WriteString("\n")
+
+	// Keep the cursor in view.
+	viewHeight := max(m.height-9, 5)
+	start := 0
+	if m.dirCursor >= viewHeight {
+		start = m.dirCursor - viewHeight + 1
+	}
+	end := min(start+viewHeight, len(m.dir.files))
+
+	for i := start; i < end; i++ {
+		f := m.dir.files[i]
+		line := fmt.Sprintf("%-5d \"%s\"%s %s", f.blocks, f.filename, strings.Repeat(" ", max(16-len(f.filename), 0)), f.listingType())
+		if i == m.dirCursor {
+			b.WriteString(selectedStyle.Render("> " + line))
+		} else if f.fileType == fileTypePRG {
+			b.WriteString("  " + line)
+		} else {
+			b.WriteString(dimStyle.Render("  " + line))
+		}
+		b.WriteString("\n")
+	}
+	b.WriteString(fmt.Sprintf("%d BLOCKS FREE.\n\n", m.dir.blocksFree))
+
+	if m.err != nil {
+		b.WriteString(errorStyle.Render(fmt.Sprintf("Error: %v", m.err)))
+		b.WriteString("\n")
+	} else if m.statusMessage != "" {
+		b.WriteString(statusStyle.Render(m.statusMessage))
+		b.WriteString("\n")
+	}
+	b.WriteString(helpStyle.Render("↑/↓: Navigate  Enter: Run file  Esc: Back"))
+	return b.String()
+}
@@ -0,0 +1,227 @@
+// Background filtering for the terminal user interface.
+// Searches are compiled and filters run as tea.Cmds off the Update loop, so typo matching
+// and lazily built indexes never block input; a shared generation counter cancels
+// scans superseded by a newer query, and the first page of matches is delivered early.
+// Completed search results are kept per query prefix so that typing narrows the
+// previous result set and backspace restores it without rescanning the index.
+package main
+
+import (
+	"strings"
+	"sync/atomic"
+
+	tea "github.com/charmbracelet/bubbletea"
+)
+
+const (
+	// filterFirstPage is how many matches are delivered before the rest of a scan completes.
+	filterFirstPage = 100
+
+	// filterCheckInterval is how many entries are scanned between cancellation checks.
+	filterCheckInterval = 4096
+)
+
+// filterJob is a single background filter run over the index.
+type filterJob struct {
+	gen        uint64
+	latest     *atomic.Uint64 // Generation of the newest job; older jobs stop when it changes.
+	index      *SearchIndex
+	candidates []int // Entry indices to scan; nil scans the whole index.
+	match      func(i int) bool
+	pos        int // Next candidate to scan.
+	results    []int
+	sentFirst  bool
+	level      *narrowLevel // Pushed onto the narrowing stack when the scan completes.
+
+	compile func() *queryPlan // If set, builds the plan before the first scan.
+	narrow  *narrowLevel      // With compile: cached results that contain all matches.
+	plan    *queryPlan        // Compiled plan, delivered with the results.
+}
+
+// narrowLevel is the complete result set of one search query within a category.
+type narrowLevel struct {
+	category string
+	query    string // Lowercased search query.
+	results  []int
+	plan     *queryPlan // Plan of the query, used to rank the results.
+}
+
+// filterResultMsg carries filter results from a background job back to Update.
+type filterResultMsg struct {
+	gen     uint64
+	results []int
+	done    bool    // False for the early first page.
+	next    tea.Cmd // Continues the scan when done is false.
+	level   *narrowLevel
+	plan    *queryPlan // Newly compiled plan of the search, or nil.
+}
+
+// run scans entries until the first page is full, the scan finishes, or the job is superseded.
+func (j *filterJob) run() tea.Msg {
+	if j.compile != nil {
+		j.plan = j.compile()
+		j.compile = nil
+		j.match = j.plan.matches
+		j.candidates = j.plan.candidates
+		if j.narrow != nil {
+			// Typo matches are not monotonic in the query, so they are rescanned too.
+			j.candidates = unionPostings(j.narrow.results, j.plan.typos)
+		}
+		if j.latest.Load() != j.gen {
+			return nil
+		}
+	}
+
+	n := len(j.index.Entries)
+	if j.candidates != nil {
+		n = len(j.candidates)
+	}
+
+	for j.pos < n {
+		if j.pos%filterCheckInterval == 0 && j.latest.Load() != j.gen {
+			return nil
+		}
+
+		i := j.pos
+		if j.candidates != nil {
+			i = j.candidates[j.pos]
+		}
+		j.pos++
+		if !j.match(i) {
+			continue
+		}
+		j.results = append(j.results, i)
+
+		if !j.sentFirst && len(j.results) == filterFirstPage {
+			j.sentFirst = true
+			page := make([]int, len(j.results))
+			copy(page, j.results)
+			return filterResultMsg{gen: j.gen, results: page, next: j.run, plan: j.plan}
+		}
+	}
+
+	if j.latest.Load() != j.gen {
+		return nil
+	}
+	if j.level != nil {
+		j.level.results = j.results
+		j.level.plan = j.plan
+	}
+	return filterResultMsg{gen: j.gen, results: j.results, done: true, level: j.level, plan: j.plan}
+}
+
+// startFilter cancels any running filter and returns a command that filters
+// the candidate entries (nil for all) in the background with the given predicate.
+// If level is not nil, the completed results are recorded on the narrowing stack.
+func (m *Model) startFilter(candidates []int, match func(i int) bool, level *narrowLevel) tea.Cmd {
+	job := m.newFilterJob(level)
+	job.candidates = candidates
+	job.match = match
+	return job.run
+}
+
+// startCompiled cancels any running filter and returns a command that compiles as in the
+// background and filters with the plan, restricted to the narrow results if not nil.
+// The model's search plan is replaced when the first results arrive.
+func (m *Model) startCompiled(as AdvancedSearch, narrow, level *narrowLevel) tea.Cmd {
+	index := m.index
+	job := m.newFilterJob(level)
+	job.compile = func() *queryPlan { return compileSearch(index, as) }
+	job.narrow = narrow
+	m.searchPlan = nil
+	return job.run
+}
+
+// newFilterJob cancels any running filter and creates the next filter job.
+func (m *Model) newFilterJob(level *narrowLevel) *filterJob {
+	m.filtering = true
+	return &filterJob{
+		gen:     m.filterGen.Add(1),
+		latest:  m.filterGen,
+		index:   m.index,
+		results: make([]int, 0, filterFirstPage),
+		level:   level,
+	}
+}
+
+// startSearch runs a category and search query, narrowing the deepest cached result
+// set whose query is a prefix of the new one. An exact hit on the narrowing stack, e.g.
+// after backspace, is applied immediately without compiling or scanning.
+func (m *Model) startSearch(category, query string) tea.Cmd {
+	// Pop levels that cannot contain all matches of the new query.
+	for len(m.narrowStack) > 0 {
+		top := m.narrowStack[len(m.narrowStack)-1]
+		if top.category == category && strings.HasPrefix(query, top.query) {
+			break
+		}
+		m.narrowStack = m.narrowStack[:len(m.narrowStack)-1]
+	}
+
+	var narrow *narrowLevel
+	if len(m.narrowStack) > 0 {
+		top := m.narrowStack[len(m.narrowStack)-1]
+		if top.query == query {
+			// Cancel any running job and reuse the cached results.
+			m.filterGen.Add(1)
+			m.filtering = false
+			m.searchPlan = top.plan
+			m.filteredResults = m.orderResults(top.results)
+			if m.cursor >= len(m.filteredResults) {
+				m.cursor = 0
+				m.scrollOffset = 0
+			}
+			return nil
+		}
+		narrow = &top
+	}
+
+	as := AdvancedSearch{Category: category, Query: query, MaxTrainers: -1}
+	return m.startCompiled(as, narrow, &narrowLevel{category: category, query: query})
+}
+
+// orderResults orders results by the selected sort key, or by relevance to the
+// search query when no sort key is selected, and drops mirrors if they are hidden.
+func (m *Model) orderResults(results []int) []int {
+	if m.sortBy == sortNone && m.searchPlan != nil && m.searchPlan.query != "" {
+		results = m.searchPlan.rank(m.index, results)
+	} else {
+		results = m.index.sortResults(results, m.sortBy)
+	}
+	if m.hideMirrors {
+		results = m.index.collapseMirrors(results)
+	}
+	return results
+}
+
+// handleFilterResult applies results from a background filter job.
+func (m Model) handleFilterResult(msg filterResultMsg) (Model, tea.Cmd) {
+	// Drop results of superseded jobs.
+	if msg.gen != m.filterGen.Load() {
+		return m, nil
+	}
+
+	// A sorted view is only shown once complete, as later matches may sort first.
+	if !msg.done && m.sortBy != sortNone {
+		return m, msg.next
+	}
+
+	if msg.plan != nil {
+		m.searchPlan = msg.plan
+	}
+	m.filteredResults = m.orderResults(msg.results)
+	m.filtering = !msg.done
+	if msg.level != nil {
+		m.narrowStack = append(m.narrowStack, *msg.level)
+	}
+
+	// Reset cursor if out of bounds.
+	if m.cursor >= len(m.filteredResults) {
+		m.cursor = 0
+		m.scrollOffset = 0
+	}
+
+	if !msg.done {
+		return m, msg.next
+	}
+	return m, nil
+}
@@ -0,0 +1,67 @@
+// "More from this group" view of the terminal user interface.
+// Ctrl+G replaces the results with every entry of the selected entry's group, or of its
+// composer if it has no group, oldest first, and Esc returns to the search results.
+package main
+
+import (
+	"fmt"
+
+	tea "github.com/charmbracelet/bubbletea"
+)
+
+// groupView is a group or composer listing shown in place of the search results.
+type groupView struct {
+	name    string
+	results []int // Entries oldest first; shared with the index and not modified.
+}
+
+// openGroup lists the entries of the selected entry's group.
+func (m *Model) openGroup() {
+	if len(m.filteredResults) == 0 {
+		return
+	}
+	entry := &m.index.Entries[m.filteredResults[m.cursor]]
+	browse := m.index.browse()
+	name, results := entry.Group, browse.groups.lookup(entry.Group)
+	if results == nil {
+		name, results = entry.Author, browse.authors.lookup(entry.Author)
+	}
+	if results == nil {
+		m.statusMessage = "Entry has no group"
+		return
+	}
+
+	// Cancel any running filter job, whose results would replace the group.
+	m.filterGen.Add(1)
+	m.filtering = false
+	m.group = &groupView{name: name, results: results}
+	m.showGroup()
+	m.statusMessage = fmt.Sprintf("More from %s (%d) - Esc: back", name, len(results))
+}
+
+// showGroup shows the group listing in the current sort order and mirror setting.
+// Without a sort key it keeps the year order of the list.
+func (m *Model) showGroup() {
+	results := m.group.results
+	if m.sortBy != sortNone {
+		results = m.index.sortResults(results, m.sortBy)
+	}
+	if m.hideMirrors {
+		results = m.index.collapseMirrors(results)
+	}
+	m.filteredResults = results
+	m.cursor = 0
+	m.scrollOffset = 0
+}
+
+// closeGroup returns from the group listing to the results of the current search.
+func (m *Model) closeGroup() tea.Cmd {
+	m.group = nil
+	m.statusMessage = ""
+	m.cursor = 0
+	m.scrollOffset = 0
+	if m.searchPlan == nil {
+		return m.applyFilters()
+	}
+	return m.startFilter(m.searchPlan.candidates, m.searchPlan.matches, nil)
+}
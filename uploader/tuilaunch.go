@@ -0,0 +1,199 @@
+// Asynchronous launches from the terminal user interface.
+// A launch runs in its own goroutine and streams progress to Update over a channel.
+// Starting a new launch cancels the previous one and waits for it to release the device,
+// and Esc cancels the launch in flight.
+package main
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"sync"
+
+	tea "github.com/charmbracelet/bubbletea"
+)
+
+// launchEventBuffer is the capacity of a launch's event channel. Progress events are
+// dropped when it is nearly full; the final result always fits.
+const launchEventBuffer = 16
+
+// launchState tracks the launch in flight, shared by all copies of the Model.
+type launchState struct {
+	mu     sync.Mutex
+	gen    uint64 // Generation of the newest launch.
+	cancel context.CancelFunc
+}
+
+// begin cancels any launch in flight and returns the generation and context of a new one.
+func (s *launchState) begin() (uint64, context.Context) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.cancel != nil {
+		s.cancel()
+	}
+	ctx, cancel := context.WithCancel(context.Background())
+	s.gen++
+	s.cancel = cancel
+	return s.gen, ctx
+}
+
+// current reports whether gen is the newest launch.
+func (s *launchState) current(gen uint64) bool {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	return s.gen == gen
+}
+
+// end releases the context of launch gen if it is still the newest one.
+func (s *launchState) end(gen uint64) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.gen == gen && s.cancel != nil {
+		s.cancel()
+		s.cancel = nil
+	}
+}
+
+// cancelCurrent cancels the launch in flight and reports whether there was one.
+func (s *launchState) cancelCurrent() bool {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.cancel == nil {
+		return false
+	}
+	s.cancel()
+	s.cancel = nil
+	return true
+}
+
+// launchMsg carries a progress event or the final result of a launch to Update.
+type launchMsg struct {
+	gen     uint64
+	name    string
+	event   launchEvent
+	done    bool
+	err     error   // Final error, when done.
+	timings string  // Per-phase timings, when done.
+	next    tea.Cmd // Waits for the next event, when not done.
+}
+
+// waitLaunch returns a command that delivers the next event of a launch.
+func waitLaunch(events chan launchMsg) tea.Cmd {
+	return func() tea.Msg {
+		msg := <-events
+		if !msg.done {
+			msg.next = waitLaunch(events)
+		}
+		return msg
+	}
+}
+
+// loadSelectedEntry starts launching the selected entry, pre-empting any launch in flight.
+func (m *Model) loadSelectedEntry() tea.Cmd {
+	if len(m.filteredResults) == 0 {
+		return func() tea.Msg {
+			return statusMsg{err: fmt.Errorf("no entry selected")}
+		}
+	}
+	return m.startLaunch(m.index.Entries[m.filteredResults[m.cursor]], firstPRGFile)
+}
+
+// startLaunch starts launching entry, pre-empting any launch in flight. For disk images,
+// file selects the PRG to run by directory position; firstPRGFile runs the first one.
+func (m *Model) startLaunch(entry ReleaseEntry, file int) tea.Cmd {
+	// Disk images flagged by dbgen would only fail after the upload.
+	if err := entry.diskError(file); err != nil {
+		m.err = fmt.Errorf("failed to load: %w", err)
+		m.statusMessage = ""
+		return nil
+	}
+
+	apiClient := m.apiClient
+	fullPath := m.index.fullPath(&entry)
+	loc := entry.prgLocation(file)
+	gen, ctx := m.launches.begin()
+	m.launching = true
+	m.err = nil
+	name := entry.Name
+	if file != firstPRGFile && m.dir != nil && file < len(m.dir.files) {
+		name = fmt.Sprintf("%s: %s", entry.Name, m.dir.files[file].filename)
+	}
+	m.statusMessage = fmt.Sprintf("Loading %s...", name)
+
+	events := make(chan launchMsg, launchEventBuffer)
+	run := func() {
+		tracker := newLaunchTracker(func(ev launchEvent) {
+			// Only this goroutine sends, so the check leaves room for the final result.
+			if len(events) < cap(events)-1 {
+				events <- launchMsg{gen: gen, name: name, event: ev}
+			}
+		})
+
+		// Read file.
+		tracker.enter(phaseRead)
+		data, err := os.ReadFile(fullPath)
+		if err != nil {
+			err = fmt.Errorf("failed to read file: %w", err)
+		} else if isDiskImageType(entry.FileType) && (file != firstPRGFile || loc.track != 0) {
+			err = apiClient.launchDiskImage(ctx, data, entry.FileType, filepath.Base(fullPath), loc, tracker)
+		} else {
+			err = apiClient.launch(ctx, data, entry.FileType, filepath.Base(fullPath), tracker)
+		}
+		events <- launchMsg{gen: gen, name: name, done: true, err: err, timings: tracker.summary()}
+	}
+
+	return func() tea.Msg {
+		go run()
+		return waitLaunch(events)()
+	}
+}
+
+// handleLaunchMsg applies progress and results of the current launch.
+func (m Model) handleLaunchMsg(msg launchMsg) (Model, tea.Cmd) {
+	// Drop events of pre-empted launches.
+	if !m.launches.current(msg.gen) {
+		return m, nil
+	}
+
+	if !msg.done {
+		m.statusMessage = formatLaunchProgress(msg.name, msg.event)
+		return m, msg.next
+	}
+
+	m.launches.end(msg.gen)
+	m.launching = false
+	switch {
+	case errors.Is(msg.err, context.Canceled):
+		m.statusMessage = fmt.Sprintf("Cancelled: %s", msg.name)
+	case msg.err != nil:
+		m.err = fmt.Errorf("failed to load: %w", msg.err)
+		m.statusMessage = ""
+	default:
+		m.statusMessage = fmt.Sprintf("✓ Loaded: %s (%s)", msg.name, msg.timings)
+	}
+	return m, nil
+}
+
+// formatLaunchProgress describes a launch event for the status line.
+func formatLaunchProgress(name string, ev launchEvent) string {
+	var action string
+	switch ev.phase {
+	case phaseRead:
+		action = "Reading"
+	case phaseExtract:
+		action = "Extracting"
+	case phaseUpload:
+		action = "Uploading"
+	case phaseMount:
+		action = "Mounting"
+	case phaseRun:
+		action = "Running"
+	}
+
+	if ev.total > 0 {
+		return fmt.Sprintf("%s %s: %d/%d KB (Esc: cancel)", action, name, ev.done/1024, (ev.total+1023)/1024)
+	}
+	return fmt.Sprintf("%s %s... (Esc: cancel)", action, name)
+}
@@ -0,0 +1,66 @@
+// Render caching for the terminal user interface.
+// Styled result rows are memoized by entry, width and selection state, and the header
+// is rebuilt only when its inputs change, so a cursor move formats just the two rows
+// whose selection changed.
+package main
+
+// renderCacheMaxRows bounds the number of cached rows; the cache is dropped when full.
+const renderCacheMaxRows = 4096
+
+// rowKey identifies one rendered result row.
+type rowKey struct {
+	entry    int
+	width    int
+	selected bool
+}
+
+// headerKey holds everything the header depends on.
+type headerKey struct {
+	index    *SearchIndex
+	category string
+	query    string
+	sortBy   sortKey
+	width    int
+}
+
+// renderCache memoizes rendered rows and the header. It is shared by all copies of
+// the Model and only used from View, which runs on the program's event loop.
+type renderCache struct {
+	index  *SearchIndex // Index the cached rows belong to.
+	rows   map[rowKey]string
+	header string
+	hkey   headerKey
+	hvalid bool
+}
+
+// newRenderCache creates an empty render cache.
+func newRenderCache() *renderCache {
+	return &renderCache{rows: make(map[rowKey]string)}
+}
+
+// row returns the rendered result row for entry, formatting it only on a cache miss.
+func (c *renderCache) row(m *Model, entry int, selected bool) string {
+	// Entry indices are only meaningful within one index.
+	if c.index != m.index || len(c.rows) >= renderCacheMaxRows {
+		c.index = m.index
+		c.rows = make(map[rowKey]string)
+	}
+
+	key := rowKey{entry: entry, width: m.width, selected: selected}
+	if line, ok := c.rows[key]; ok {
+		return line
+	}
+	line := m.formatEntry(m.index.Entries[entry], selected)
+	c.rows[key] = line
+	return line
+}
+
+// cachedHeader returns the header for key, building it with build on a cache miss.
+func (c *renderCache) cachedHeader(key headerKey, build func() string) string {
+	if !c.hvalid || c.hkey != key {
+		c.header = build()
+		c.hkey = key
+		c.hvalid = true
+	}
+	return c.header
+}